@@ -11,22 +11,228 @@
 #include "widgets/layer_status.h"
 #include "widgets/output_status.h"
 #include "widgets/hid_indicators.h"
+#include "widgets/stats_page.h"
+#include "widgets/heatmap_page.h"
+#include "src/boot_timing.h"
+#include "src/display_monitor.h"
 
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/atomic.h>
+#include <zmk/display.h>
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
-static struct zmk_widget_output_status output_status_widget;
-static struct zmk_widget_layer_status layer_status_widget;
-static struct zmk_widget_peripheral_battery_status peripheral_battery_status_widget;
-static struct zmk_widget_modifiers modifiers_widget;
-static struct zmk_widget_bongo_cat bongo_cat_widget;
+/*
+ * Every widget exists exactly once. STATUS_WIDGET_DEFINE gives it a static instance and a
+ * create function returning its root object; the layout tables below only reference ids.
+ */
+#define STATUS_WIDGET_DEFINE(name)                                                                 \
+    static struct zmk_widget_##name name##_widget;                                                 \
+    static lv_obj_t *name##_create(lv_obj_t *parent) {                                            \
+        zmk_widget_##name##_init(&name##_widget, parent);                                          \
+        return zmk_widget_##name##_obj(&name##_widget);                                            \
+    }
 
+STATUS_WIDGET_DEFINE(output_status)
+STATUS_WIDGET_DEFINE(layer_status)
+STATUS_WIDGET_DEFINE(peripheral_battery_status)
+STATUS_WIDGET_DEFINE(modifiers)
+STATUS_WIDGET_DEFINE(bongo_cat)
 #if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
-static struct zmk_widget_hid_indicators hid_indicators_widget;
+STATUS_WIDGET_DEFINE(hid_indicators)
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_TYPING_STATS)
+STATUS_WIDGET_DEFINE(stats_page)
 #endif
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_HEATMAP_PAGE)
+STATUS_WIDGET_DEFINE(heatmap_page)
+#endif
+
+enum status_widget_id {
+    status_widget_output_status,
+    status_widget_layer_status,
+    status_widget_peripheral_battery_status,
+    status_widget_modifiers,
+    status_widget_bongo_cat,
+    status_widget_hid_indicators,
+    status_widget_count,
+};
+
+static lv_obj_t *(*const status_widget_create[status_widget_count])(lv_obj_t *parent) = {
+    [status_widget_output_status] = output_status_create,
+    [status_widget_layer_status] = layer_status_create,
+    [status_widget_peripheral_battery_status] = peripheral_battery_status_create,
+    [status_widget_modifiers] = modifiers_create,
+    [status_widget_bongo_cat] = bongo_cat_create,
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+    [status_widget_hid_indicators] = hid_indicators_create,
+#endif
+};
+
+/* align relative to the screen instead of another widget */
+#define STATUS_WIDGET_SCREEN status_widget_count
+
+struct status_widget_layout {
+    enum status_widget_id id;
+    enum status_widget_id base;
+    lv_align_t align;
+    lv_coord_t x_ofs;
+    lv_coord_t y_ofs;
+    /* still shown while the display power manager has the screen in its partial state */
+    bool essential;
+};
+
+/* Entries are created in order, so a base must come before the widgets aligned to it */
+#if DT_PROP(DT_CHOSEN(zephyr_display), height) >= 64
+static const struct status_widget_layout status_layout[] = {
+    {status_widget_output_status, STATUS_WIDGET_SCREEN, LV_ALIGN_TOP_LEFT, 0, 0, true},
+    {status_widget_bongo_cat, STATUS_WIDGET_SCREEN, LV_ALIGN_BOTTOM_RIGHT, 0, -7, false},
+    {status_widget_modifiers, STATUS_WIDGET_SCREEN, LV_ALIGN_BOTTOM_LEFT, 0, 0, false},
+    {status_widget_layer_status, status_widget_modifiers, LV_ALIGN_OUT_TOP_LEFT, 0, -2, true},
+    {status_widget_hid_indicators, STATUS_WIDGET_SCREEN, LV_ALIGN_BOTTOM_RIGHT, 0, 0, false},
+    {status_widget_peripheral_battery_status, STATUS_WIDGET_SCREEN, LV_ALIGN_TOP_RIGHT, 0, 0,
+     false},
+};
+#else
+/* 128x32: no room for the bongo cat, layer name moves next to the output status */
+static const struct status_widget_layout status_layout[] = {
+    {status_widget_output_status, STATUS_WIDGET_SCREEN, LV_ALIGN_TOP_LEFT, 0, 0, true},
+    {status_widget_layer_status, status_widget_output_status, LV_ALIGN_OUT_RIGHT_TOP, 4, 0, true},
+    {status_widget_modifiers, STATUS_WIDGET_SCREEN, LV_ALIGN_BOTTOM_LEFT, 0, 0, false},
+    {status_widget_hid_indicators, STATUS_WIDGET_SCREEN, LV_ALIGN_BOTTOM_RIGHT, 0, 0, false},
+    {status_widget_peripheral_battery_status, STATUS_WIDGET_SCREEN, LV_ALIGN_TOP_RIGHT, 0, 0,
+     false},
+};
+#endif
+
+/* Full-screen pages cycled with &dpg, page 0 holds the status widgets laid out above */
+static lv_obj_t *(*const status_page_create[])(lv_obj_t *parent) = {
+    NULL,
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_TYPING_STATS)
+    stats_page_create,
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_HEATMAP_PAGE)
+    heatmap_page_create,
+#endif
+};
 
 lv_style_t global_style;
 
+static lv_obj_t *objs[status_widget_count];
+static lv_obj_t *pages[ARRAY_SIZE(status_page_create)];
+
+/* only touched from the display work queue */
+static uint8_t current_page;
+static atomic_t page_steps;
+
+static void show_page(uint8_t page) {
+    for (int i = 0; i < ARRAY_SIZE(pages); i++) {
+        if (pages[i] == NULL) {
+            continue;
+        }
+        if (i == page) {
+            lv_obj_clear_flag(pages[i], LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(pages[i], LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+    current_page = page;
+}
+
+static void page_work_cb(struct k_work *work) {
+    atomic_val_t steps = atomic_clear(&page_steps);
+
+    uint8_t page = (current_page + steps) % ARRAY_SIZE(pages);
+
+    /* pages still being created at boot are skipped */
+    if (pages[page] != NULL) {
+        show_page(page);
+    }
+}
+
+static K_WORK_DEFINE(page_work, page_work_cb);
+
+void zmk_display_status_screen_next_page(void) {
+    atomic_inc(&page_steps);
+    k_work_submit_to_queue(zmk_display_work_q(), &page_work);
+}
+
+void zmk_display_status_screen_set_minimal(bool minimal) {
+    if (minimal && pages[0] != NULL) {
+        show_page(0);
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(status_layout); i++) {
+        lv_obj_t *obj = objs[status_layout[i].id];
+
+        if (obj == NULL || status_layout[i].essential) {
+            continue;
+        }
+
+        if (minimal) {
+            lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+}
+
+void zmk_display_status_screen_set_animations(bool enabled) {
+    if (objs[status_widget_bongo_cat] != NULL) {
+        zmk_widget_bongo_cat_set_paused(&bongo_cat_widget, !enabled);
+    }
+}
+
+static lv_obj_t *create_page(lv_obj_t *screen) {
+    lv_obj_t *page = lv_obj_create(screen);
+    lv_obj_remove_style_all(page);
+    lv_obj_clear_flag(page, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(page, LV_PCT(100), LV_PCT(100));
+    return page;
+}
+
+static void create_status_widget(const struct status_widget_layout *entry) {
+    if (status_widget_create[entry->id] == NULL) {
+        return;
+    }
+
+    objs[entry->id] = status_widget_create[entry->id](pages[0]);
+
+    if (entry->base != STATUS_WIDGET_SCREEN && objs[entry->base] != NULL) {
+        lv_obj_align_to(objs[entry->id], objs[entry->base], entry->align, entry->x_ofs,
+                        entry->y_ofs);
+    } else {
+        lv_obj_align(objs[entry->id], entry->align, entry->x_ofs, entry->y_ofs);
+    }
+}
+
+/*
+ * Only the first layout entry is created before the screen is loaded. The remaining widgets
+ * and pages follow one per display queue pass, so the first frame goes out early and no single
+ * pass holds the display thread for the whole tree.
+ */
+static lv_obj_t *pending_screen;
+static uint8_t next_widget = 1;
+static uint8_t next_page = 1;
+
+static void create_work_cb(struct k_work *work) {
+    if (next_widget < ARRAY_SIZE(status_layout)) {
+        create_status_widget(&status_layout[next_widget++]);
+    } else if (next_page < ARRAY_SIZE(pages)) {
+        pages[next_page] = create_page(pending_screen);
+        lv_obj_align(status_page_create[next_page](pages[next_page]), LV_ALIGN_TOP_LEFT, 0, 0);
+        lv_obj_add_flag(pages[next_page], LV_OBJ_FLAG_HIDDEN);
+        next_page++;
+    } else {
+        boot_timing_mark(boot_stage_screen_complete);
+        return;
+    }
+
+    k_work_submit_to_queue(zmk_display_work_q(), work);
+}
+
+static K_WORK_DEFINE(create_work, create_work_cb);
+
 lv_obj_t *zmk_display_status_screen() {
     lv_obj_t *screen;
 
@@ -37,27 +243,17 @@ lv_obj_t *zmk_display_status_screen() {
     lv_style_set_text_letter_space(&global_style, 1);
     lv_style_set_text_line_space(&global_style, 1);
     lv_obj_add_style(screen, &global_style, LV_PART_MAIN);
-    
-    zmk_widget_output_status_init(&output_status_widget, screen);
-    lv_obj_align(zmk_widget_output_status_obj(&output_status_widget), LV_ALIGN_TOP_LEFT, 0, 0);
-    
-    zmk_widget_bongo_cat_init(&bongo_cat_widget, screen);
-    lv_obj_align(zmk_widget_bongo_cat_obj(&bongo_cat_widget), LV_ALIGN_BOTTOM_RIGHT, 0, -7);
-
-    zmk_widget_modifiers_init(&modifiers_widget, screen);
-    lv_obj_align(zmk_widget_modifiers_obj(&modifiers_widget), LV_ALIGN_BOTTOM_LEFT, 0, 0);
-    
-    zmk_widget_layer_status_init(&layer_status_widget, screen);
-    lv_obj_align_to(zmk_widget_layer_status_obj(&layer_status_widget), zmk_widget_modifiers_obj(&modifiers_widget), LV_ALIGN_OUT_TOP_LEFT, 0, -2);
-
-    #if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
-    zmk_widget_hid_indicators_init(&hid_indicators_widget, screen);
-    // lv_obj_align_to(zmk_widget_hid_indicators_obj(&hid_indicators_widget), zmk_widget_bongo_cat_obj(&bongo_cat_widget), LV_ALIGN_BOTTOM_RIGHT, -5, 5);
-    lv_obj_align(zmk_widget_hid_indicators_obj(&hid_indicators_widget), LV_ALIGN_BOTTOM_RIGHT, 0, 0);
-    #endif
-
-    zmk_widget_peripheral_battery_status_init(&peripheral_battery_status_widget, screen);
-    lv_obj_align(zmk_widget_peripheral_battery_status_obj(&peripheral_battery_status_widget), LV_ALIGN_TOP_RIGHT, 0, 0);
+
+    pages[0] = create_page(screen);
+    create_status_widget(&status_layout[0]);
+    show_page(0);
+
+    boot_timing_mark(boot_stage_screen);
+    display_monitor_attach(lv_disp_get_default());
+
+    /* runs once ZMK has loaded the screen and returned to the queue */
+    pending_screen = screen;
+    k_work_submit_to_queue(zmk_display_work_q(), &create_work);
 
     return screen;
-}
\ No newline at end of file
+}
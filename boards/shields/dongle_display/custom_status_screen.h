@@ -9,4 +9,11 @@
 
 #include <lvgl.h>
 
-lv_obj_t *zmk_display_status_screen();
\ No newline at end of file
+lv_obj_t *zmk_display_status_screen();
+
+/* hide everything but the layer and output widgets, used while the display is idle */
+void zmk_display_status_screen_set_minimal(bool minimal);
+void zmk_display_status_screen_set_animations(bool enabled);
+
+/* safe to call from any thread, the switch happens on the display work queue */
+void zmk_display_status_screen_next_page(void);
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+"""
+Cut 1-bpp glyph subsets out of LVGL's built-in fonts.
+
+Only the characters the status screen can actually show are kept: the layer names found in the
+keymap plus a fixed set per subset. The 4-bpp glyphs of the source font are thresholded to 1 bpp
+and every glyph row is padded to a whole byte, so the blitter can shift rows straight into a 1-bpp
+canvas.
+"""
+
+import argparse
+import re
+import sys
+
+# same limit as the label text buffer in layer_status.c
+MAX_LAYER_NAME = 12
+
+
+def parse_lvgl_font(path):
+    with open(path, encoding="utf-8") as f:
+        src = f.read()
+
+    src_nc = re.sub(r"/\*.*?\*/", "", src, flags=re.S)
+
+    def field(name):
+        m = re.search(r"\." + name + r"\s*=\s*(\d+)", src_nc)
+        if not m:
+            sys.exit(f"{path}: no .{name}")
+        return int(m.group(1))
+
+    if field("bpp") != 4 or field("bitmap_format") != 0:
+        sys.exit(f"{path}: only uncompressed 4 bpp fonts are supported")
+
+    m = re.search(r"glyph_bitmap\[\]\s*=\s*\{(.*?)\};", src_nc, flags=re.S)
+    bitmap = [int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]+", m.group(1))]
+
+    m = re.search(r"glyph_dsc\[\]\s*=\s*\{(.*?)\};", src_nc, flags=re.S)
+    glyphs = []
+    for entry in re.findall(r"\{([^{}]*)\}", m.group(1)):
+        glyphs.append({k: int(v) for k, v in re.findall(r"\.(\w+)\s*=\s*(-?\d+)", entry)})
+
+    # the printable ASCII range is always the first, contiguous cmap
+    m = re.search(
+        r"\.range_start\s*=\s*(\d+),\s*\.range_length\s*=\s*(\d+),\s*\.glyph_id_start\s*=\s*(\d+)",
+        src_nc,
+    )
+    range_start, range_length, id_start = (int(v) for v in m.groups())
+
+    cmap = {range_start + i: id_start + i for i in range(range_length)}
+
+    return {
+        "line_height": field("line_height"),
+        "base_line": field("base_line"),
+        "bitmap": bitmap,
+        "glyphs": glyphs,
+        "cmap": cmap,
+    }
+
+
+def glyph_rows(font, glyph):
+    """Threshold a packed 4-bpp glyph into byte padded 1-bpp rows"""
+    w, h = glyph["box_w"], glyph["box_h"]
+    start = glyph["bitmap_index"]
+    out = []
+    for y in range(h):
+        row = [0] * ((w + 7) // 8)
+        for x in range(w):
+            px = y * w + x
+            byte = font["bitmap"][start + px // 2]
+            level = (byte >> 4) if px % 2 == 0 else (byte & 0x0F)
+            if level >= 8:
+                row[x // 8] |= 0x80 >> (x % 8)
+        out.extend(row)
+    return out
+
+
+def keymap_layer_names(path):
+    with open(path, encoding="utf-8") as f:
+        src = re.sub(r"//[^\n]*|/\*.*?\*/", "", f.read(), flags=re.S)
+
+    start = src.find('"zmk,keymap"')
+    if start < 0:
+        return []
+    names = re.findall(r"(?:display-name|label)\s*=\s*\"([^\"]*)\"", src[start:])
+    return [n[:MAX_LAYER_NAME] for n in names]
+
+
+def text_width(font, text):
+    width = 0
+    for ch in text:
+        gid = font["cmap"].get(ord(ch))
+        if gid is not None:
+            width += font["glyphs"][gid]["adv_w"]
+    return (width + 15) // 16
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--out-c", required=True)
+    parser.add_argument("--out-h", required=True)
+    parser.add_argument("--keymap", help="keymap to take the layer names from")
+    parser.add_argument(
+        "--subset",
+        nargs=3,
+        action="append",
+        metavar=("NAME", "FONT", "CHARS"),
+        required=True,
+        help="subset NAME of the LVGL font source FONT with CHARS",
+    )
+    parser.add_argument(
+        "--keymap-subset", action="append", default=[], help="also add the layer names to NAME"
+    )
+    args = parser.parse_args()
+
+    layer_names = keymap_layer_names(args.keymap) if args.keymap else []
+
+    c = [
+        "/* generated by gen_glyph_subsets.py, do not edit */",
+        "",
+        '#include "glyph_blit.h"',
+        "",
+    ]
+    h = [
+        "/* generated by gen_glyph_subsets.py, do not edit */",
+        "",
+        "#pragma once",
+        "",
+    ]
+
+    for name, font_path, chars in args.subset:
+        font = parse_lvgl_font(font_path)
+
+        samples = [chars]
+        if name in args.keymap_subset:
+            samples += layer_names
+        charset = sorted({ord(ch) for s in samples for ch in s if ord(ch) in font["cmap"]})
+
+        bitmap = []
+        entries = []
+        for cp in charset:
+            glyph = font["glyphs"][font["cmap"][cp]]
+            entries.append(
+                f"    {{.codepoint = {cp}, .bitmap_index = {len(bitmap)}, "
+                f".adv = {(glyph['adv_w'] + 8) // 16}, .box_w = {glyph['box_w']}, "
+                f".box_h = {glyph['box_h']}, .ofs_x = {glyph['ofs_x']}, "
+                f".ofs_y = {glyph['ofs_y']}}},"
+            )
+            bitmap += glyph_rows(font, glyph)
+
+        max_width = max(text_width(font, s) for s in samples)
+
+        c.append(f"static const uint8_t {name}_bitmap[] = {{")
+        for i in range(0, len(bitmap), 12):
+            c.append("    " + " ".join(f"0x{b:02x}," for b in bitmap[i : i + 12]))
+        c.append("};")
+        c.append("")
+        c.append(f"static const struct glyph_subset_glyph {name}_glyphs[] = {{")
+        c += entries
+        c.append("};")
+        c.append("")
+        c.append(f"const struct glyph_subset glyph_subset_{name} = {{")
+        c.append(f"    .line_height = {font['line_height']},")
+        c.append(f"    .base_line = {font['base_line']},")
+        c.append(f"    .count = ARRAY_SIZE({name}_glyphs),")
+        c.append(f"    .glyphs = {name}_glyphs,")
+        c.append(f"    .bitmap = {name}_bitmap,")
+        c.append("};")
+        c.append("")
+
+        h.append(f"extern const struct glyph_subset glyph_subset_{name};")
+        h.append(f"#define GLYPH_SUBSET_{name.upper()}_LINE_HEIGHT {font['line_height']}")
+        h.append(f"/* widest string the subset was built for */")
+        h.append(f"#define GLYPH_SUBSET_{name.upper()}_MAX_WIDTH {max_width}")
+        h.append("")
+
+    with open(args.out_c, "w", encoding="utf-8") as f:
+        f.write("\n".join(c))
+    with open(args.out_h, "w", encoding="utf-8") as f:
+        f.write("\n".join(h))
+
+
+if __name__ == "__main__":
+    main()
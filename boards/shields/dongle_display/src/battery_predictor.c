@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/ble.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/battery_state_changed.h>
+
+#include "battery_predictor.h"
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_SPLIT_RECONNECT)
+#include "events/split_central_status_changed.h"
+#endif
+
+/* new samples get a quarter of the weight, enough to follow a change in usage within the hour */
+#define EWMA_SHIFT 2
+
+/* consecutive rising reports that mean charging rather than ADC noise */
+#define CHARGING_RISES 2
+
+struct battery_model {
+    /* level the model tracks, single percent rises are not taken over */
+    uint8_t level;
+    uint8_t last_report;
+    uint8_t rises;
+    /* set once a drop has been seen, the first report is no reference for timing */
+    bool anchored;
+    /* last drop, or when the model was last reset, the reference for the estimate */
+    int64_t dropped_at;
+    /* smoothed time it takes to lose one percent, 0 while unknown */
+    uint32_t ms_per_pct;
+};
+
+/* only touched from the event thread */
+static struct battery_model models[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+
+/* drop the timing reference, the learned rate is still a good prior */
+static void battery_model_reset(struct battery_model *model, int64_t now) {
+    model->anchored = false;
+    model->dropped_at = now;
+}
+
+static void battery_model_update(struct battery_model *model, uint8_t level) {
+    int64_t now = k_uptime_get();
+
+    model->rises = level > model->last_report ? model->rises + 1 : 0;
+    model->last_report = level;
+
+    /* first report, or charging: a jump, or a level that keeps climbing a percent at a time */
+    if (model->level == 0 || level > model->level + 1 ||
+        (level > model->level && model->rises >= CHARGING_RISES)) {
+        model->level = level;
+        battery_model_reset(model, now);
+        return;
+    }
+
+    /* a single percent up is ADC noise, not charging */
+    if (level >= model->level) {
+        return;
+    }
+
+    if (model->anchored) {
+        uint32_t sample = (uint32_t)((now - model->dropped_at) / (model->level - level));
+
+        if (model->ms_per_pct == 0) {
+            model->ms_per_pct = sample;
+        } else {
+            model->ms_per_pct += ((int32_t)sample - (int32_t)model->ms_per_pct) >> EWMA_SHIFT;
+        }
+    }
+
+    model->level = level;
+    model->anchored = true;
+    model->dropped_at = now;
+}
+
+static int battery_predictor_listener(const zmk_event_t *eh) {
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_SPLIT_RECONNECT)
+    const struct zmk_split_central_status_changed *status =
+        as_zmk_split_central_status_changed(eh);
+
+    /* time spent disconnected or asleep is no discharge the model saw */
+    if (status != NULL && status->slot < ARRAY_SIZE(models)) {
+        battery_model_reset(&models[status->slot], k_uptime_get());
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+#endif
+
+    const struct zmk_peripheral_battery_state_changed *ev =
+        as_zmk_peripheral_battery_state_changed(eh);
+
+    if (ev != NULL && ev->source < ARRAY_SIZE(models)) {
+        battery_model_update(&models[ev->source], ev->state_of_charge);
+        LOG_DBG("Peripheral %d at %d%%, %d min left", ev->source, ev->state_of_charge,
+                battery_predictor_minutes_left(ev->source));
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(battery_predictor, battery_predictor_listener);
+ZMK_SUBSCRIPTION(battery_predictor, zmk_peripheral_battery_state_changed);
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_SPLIT_RECONNECT)
+ZMK_SUBSCRIPTION(battery_predictor, zmk_split_central_status_changed);
+#endif
+
+int32_t battery_predictor_minutes_left(uint8_t source) {
+    if (source >= ARRAY_SIZE(models) || models[source].ms_per_pct == 0) {
+        return -1;
+    }
+
+    const struct battery_model *model = &models[source];
+    int64_t left_ms = (int64_t)model->level * model->ms_per_pct -
+                      (k_uptime_get() - model->dropped_at);
+
+    return (int32_t)(MAX(left_ms, 0) / MSEC_PER_SEC / 60);
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+/*
+ * Discharge model per split peripheral, fed by the battery level reports the central already
+ * receives. Returns the estimated minutes until the peripheral reaches 0%, or -1 while the
+ * model has not seen enough level drops to tell.
+ */
+int32_t battery_predictor_minutes_left(uint8_t source);
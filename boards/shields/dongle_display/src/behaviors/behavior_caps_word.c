@@ -7,12 +7,15 @@
 #define DT_DRV_COMPAT zmk_behavior_caps_word
 
 #include <zephyr/device.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/math_extras.h>
 #include <drivers/behavior.h>
 #include <zephyr/logging/log.h>
 #include <zmk/behavior.h>
 
 #include <zmk/endpoints.h>
 #include <zmk/event_manager.h>
+#include <zmk/events/endpoint_changed.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/keycode_state_changed.h>
 #include <zmk/events/modifiers_state_changed.h>
@@ -21,6 +24,7 @@
 #include <zmk/keymap.h>
 
 #include "../events/caps_word_state_changed.h"
+#include "../listener_profiler.h"
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -40,37 +44,62 @@ struct behavior_caps_word_config {
 };
 
 struct behavior_caps_word_data {
-    bool active;
+    /* one bit per endpoint, indexed by zmk_endpoint_instance_to_index() */
+    uint32_t active_endpoints;
 };
 
-static void activate_caps_word(const struct device *dev) {
-    struct behavior_caps_word_data *data = dev->data;
+BUILD_ASSERT(ZMK_ENDPOINT_COUNT <= 32, "caps word tracks endpoints in a 32 bit mask");
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT) <= 32,
+             "caps word tracks instances in a 32 bit mask");
+
+static const struct device *devs[DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT)];
+
+/* Instances that are active on the current endpoint, the only thing the key path looks at */
+static atomic_t active_instances;
+
+/* endpoints.c also starts out on USB and raises zmk_endpoint_changed once it settles */
+static int current_endpoint;
 
-    data->active = true;
+static void update_active_instances(void) {
+    atomic_val_t mask = 0;
 
-    raise_zmk_caps_word_state_changed(
-        (struct zmk_caps_word_state_changed){.active = true});
+    for (int i = 0; i < ARRAY_SIZE(devs); i++) {
+        if (devs[i] == NULL) {
+            continue;
+        }
+
+        const struct behavior_caps_word_data *data = devs[i]->data;
+        if (data->active_endpoints & BIT(current_endpoint)) {
+            mask |= BIT(i);
+        }
+    }
+
+    atomic_val_t old = atomic_set(&active_instances, mask);
+
+    /* the indicator only cares whether caps word is on for the host being typed at */
+    if ((old != 0) != (mask != 0)) {
+        raise_zmk_caps_word_state_changed(
+            (struct zmk_caps_word_state_changed){.active = mask != 0});
+    }
 }
 
-static void deactivate_caps_word(const struct device *dev) {
-    struct behavior_caps_word_data *data = dev->data;
+static bool caps_word_is_active(const struct device *dev) {
+    const struct behavior_caps_word_data *data = dev->data;
+    return data->active_endpoints & BIT(current_endpoint);
+}
 
-    data->active = false;
+static void set_caps_word(const struct device *dev, bool active) {
+    struct behavior_caps_word_data *data = dev->data;
 
-    raise_zmk_caps_word_state_changed(
-        (struct zmk_caps_word_state_changed){.active = false});
+    WRITE_BIT(data->active_endpoints, current_endpoint, active);
+    update_active_instances();
 }
 
 static int on_caps_word_binding_pressed(struct zmk_behavior_binding *binding,
                                         struct zmk_behavior_binding_event event) {
     const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
-    struct behavior_caps_word_data *data = dev->data;
 
-    if (data->active) {
-        deactivate_caps_word(dev);
-    } else {
-        activate_caps_word(dev);
-    }
+    set_caps_word(dev, !caps_word_is_active(dev));
 
     return ZMK_BEHAVIOR_OPAQUE;
 }
@@ -93,15 +122,24 @@ static int caps_word_keycode_state_changed_listener(const zmk_event_t *eh);
 ZMK_LISTENER(behavior_caps_word, caps_word_keycode_state_changed_listener);
 ZMK_SUBSCRIPTION(behavior_caps_word, zmk_keycode_state_changed);
 
-static const struct device *devs[DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT)];
+static int caps_word_endpoint_changed_listener(const zmk_event_t *eh) {
+    const struct zmk_endpoint_changed *ev = as_zmk_endpoint_changed(eh);
+    if (ev != NULL) {
+        current_endpoint = zmk_endpoint_instance_to_index(ev->endpoint);
+        update_active_instances();
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(behavior_caps_word_endpoint, caps_word_endpoint_changed_listener);
+ZMK_SUBSCRIPTION(behavior_caps_word_endpoint, zmk_endpoint_changed);
 
 static bool caps_word_is_caps_includelist(const struct behavior_caps_word_config *config,
                                           uint16_t usage_page, uint8_t usage_id,
                                           uint8_t implicit_modifiers) {
     for (int i = 0; i < config->continuations_count; i++) {
         const struct caps_word_continue_item *continuation = &config->continuations[i];
-        LOG_DBG("Comparing with 0x%02X - 0x%02X (with implicit mods: 0x%02X)", continuation->page,
-                continuation->id, continuation->implicit_modifiers);
 
         if (continuation->page == usage_page && continuation->id == usage_id &&
             (continuation->implicit_modifiers &
@@ -131,29 +169,27 @@ static void caps_word_enhance_usage(const struct behavior_caps_word_config *conf
         return;
     }
 
-    LOG_DBG("Enhancing usage 0x%02X with modifiers: 0x%02X", ev->keycode, config->mods);
     ev->implicit_modifiers |= config->mods;
 }
 
-static int caps_word_keycode_state_changed_listener(const zmk_event_t *eh) {
+static int caps_word_handle_keycode_state_changed(const zmk_event_t *eh) {
+    atomic_val_t active = atomic_get(&active_instances);
+    if (active == 0) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
     struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
     if (ev == NULL || !ev->state) {
         return ZMK_EV_EVENT_BUBBLE;
     }
 
-    for (int i = 0; i < DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT); i++) {
+    while (active != 0) {
+        int i = u32_count_trailing_zeros(active);
         const struct device *dev = devs[i];
-        if (dev == NULL) {
-            continue;
-        }
-
-        struct behavior_caps_word_data *data = dev->data;
-        if (!data->active) {
-            continue;
-        }
-
         const struct behavior_caps_word_config *config = dev->config;
 
+        active &= ~BIT(i);
+
         caps_word_enhance_usage(config, ev);
 
         if (!caps_word_is_alpha(ev->keycode) && !caps_word_is_numeric(ev->keycode) &&
@@ -161,13 +197,20 @@ static int caps_word_keycode_state_changed_listener(const zmk_event_t *eh) {
             !caps_word_is_caps_includelist(config, ev->usage_page, ev->keycode,
                                            ev->implicit_modifiers)) {
             LOG_DBG("Deactivating caps_word for 0x%02X - 0x%02X", ev->usage_page, ev->keycode);
-            deactivate_caps_word(dev);
+            set_caps_word(dev, false);
         }
     }
 
     return ZMK_EV_EVENT_BUBBLE;
 }
 
+static int caps_word_keycode_state_changed_listener(const zmk_event_t *eh) {
+    timing_t profile_start = listener_profiler_start();
+    int ret = caps_word_handle_keycode_state_changed(eh);
+    listener_profiler_stop("behavior_caps_word", eh, profile_start);
+    return ret;
+}
+
 static int behavior_caps_word_init(const struct device *dev) {
     const struct behavior_caps_word_config *config = dev->config;
     devs[config->index] = dev;
@@ -182,7 +225,7 @@ static int behavior_caps_word_init(const struct device *dev) {
 #define BREAK_ITEM(i, n) PARSE_BREAK(DT_INST_PROP_BY_IDX(n, continue_list, i))
 
 #define KP_INST(n)                                                                                 \
-    static struct behavior_caps_word_data behavior_caps_word_data_##n = {.active = false};         \
+    static struct behavior_caps_word_data behavior_caps_word_data_##n;                             \
     static struct behavior_caps_word_config behavior_caps_word_config_##n = {                      \
         .index = n,                                                                                \
         .mods = DT_INST_PROP_OR(n, mods, MOD_LSFT),                                                \
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/ble.h>
+#include <zmk/endpoints.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/ble_active_profile_changed.h>
+#include <zmk/events/keycode_state_changed.h>
+
+#include "ble_switch_timer.h"
+#include "events/ble_switch_timed.h"
+
+/*
+ * Times a BLE profile switch as the user sees it. A host that is still connected from earlier
+ * is ready immediately, a cold one has to go through advertising and reconnection first.
+ * Both events arrive on the system work queue, so the state below needs no locking.
+ */
+static struct zmk_ble_switch_time last_switch = {.profile = -1};
+
+static int switch_profile = -1;
+static int64_t switch_at;
+static int64_t ready_at;
+static bool pending;
+
+struct zmk_ble_switch_time zmk_ble_switch_time_get(void) { return last_switch; }
+
+static void on_profile_changed(const struct zmk_ble_active_profile_changed *ev) {
+    /* the active profile event is raised again once its link comes up */
+    if (ev->index != switch_profile) {
+        /* the profile restored at boot is not a switch */
+        pending = switch_profile >= 0;
+        switch_profile = ev->index;
+        switch_at = k_uptime_get();
+        ready_at = 0;
+    }
+
+    if (pending && ready_at == 0 && zmk_ble_active_profile_is_connected()) {
+        ready_at = k_uptime_get();
+        LOG_DBG("Profile %d ready after %lld ms", switch_profile, ready_at - switch_at);
+    }
+}
+
+static void on_key_pressed(void) {
+    if (!pending || zmk_endpoints_selected().transport != ZMK_TRANSPORT_BLE) {
+        return;
+    }
+
+    /* keys pressed while the host is still connecting never reach it */
+    if (!zmk_ble_active_profile_is_connected()) {
+        return;
+    }
+
+    int64_t now = k_uptime_get();
+
+    /* the connected callback may not have raised its profile event yet */
+    if (ready_at == 0) {
+        ready_at = now;
+    }
+
+    pending = false;
+    last_switch = (struct zmk_ble_switch_time){
+        .profile = switch_profile,
+        .ready_ms = MIN(ready_at - switch_at, UINT16_MAX),
+        .first_key_ms = MIN(now - switch_at, UINT16_MAX),
+    };
+
+    LOG_INF("Profile %d switch: ready %u ms, first key %u ms", last_switch.profile,
+            last_switch.ready_ms, last_switch.first_key_ms);
+
+    raise_zmk_ble_switch_timed((struct zmk_ble_switch_timed){
+        .profile = last_switch.profile,
+        .ready_ms = last_switch.ready_ms,
+        .first_key_ms = last_switch.first_key_ms,
+    });
+}
+
+static int ble_switch_timer_listener(const zmk_event_t *eh) {
+    const struct zmk_ble_active_profile_changed *profile = as_zmk_ble_active_profile_changed(eh);
+    if (profile != NULL) {
+        on_profile_changed(profile);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_keycode_state_changed *keycode = as_zmk_keycode_state_changed(eh);
+    if (keycode != NULL && keycode->state) {
+        on_key_pressed();
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(ble_switch_timer, ble_switch_timer_listener);
+ZMK_SUBSCRIPTION(ble_switch_timer, zmk_ble_active_profile_changed);
+ZMK_SUBSCRIPTION(ble_switch_timer, zmk_keycode_state_changed);
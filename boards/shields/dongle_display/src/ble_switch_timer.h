@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+struct zmk_ble_switch_time {
+    /* profile the measurement belongs to, -1 before the first switch */
+    int8_t profile;
+    /* from the profile switch until the host link was up */
+    uint16_t ready_ms;
+    /* from the profile switch until the first key press reached the host */
+    uint16_t first_key_ms;
+};
+
+struct zmk_ble_switch_time zmk_ble_switch_time_get(void);
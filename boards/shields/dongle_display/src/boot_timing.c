@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if IS_ENABLED(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+#include <zmk/ble.h>
+#include <zmk/endpoints.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/ble_active_profile_changed.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/usb_conn_state_changed.h>
+#include <zmk/usb.h>
+
+#include "boot_timing.h"
+
+static const char *const stage_names[boot_stage_count] = {
+    [boot_stage_post_kernel] = "post_kernel",
+    [boot_stage_application] = "application",
+    [boot_stage_screen] = "screen",
+    [boot_stage_screen_complete] = "screen_complete",
+    [boot_stage_host_ready] = "host_ready",
+    [boot_stage_first_report] = "first_report",
+};
+
+/* uptime + 1, so that 0 can mean "not reached" even for a mark taken at uptime 0 */
+static atomic_t marks[boot_stage_count];
+
+void boot_timing_mark(enum boot_stage stage) {
+    uint32_t now = k_uptime_get_32();
+
+    if (atomic_cas(&marks[stage], 0, now + 1)) {
+        LOG_INF("Boot stage %s at %u ms", stage_names[stage], now);
+    }
+}
+
+int32_t boot_timing_ms(enum boot_stage stage) { return (int32_t)atomic_get(&marks[stage]) - 1; }
+
+static bool host_ready(void) {
+    struct zmk_endpoint_instance endpoint = zmk_endpoints_selected();
+
+#if IS_ENABLED(CONFIG_ZMK_USB)
+    if (endpoint.transport == ZMK_TRANSPORT_USB) {
+        return zmk_usb_is_hid_ready();
+    }
+#endif
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+    if (endpoint.transport == ZMK_TRANSPORT_BLE) {
+        return zmk_ble_active_profile_is_connected();
+    }
+#endif
+
+    return false;
+}
+
+/* unsubscribing is not possible, after the last stage this returns on the first check */
+static int boot_timing_listener(const zmk_event_t *eh) {
+    if (boot_timing_ms(boot_stage_first_report) >= 0 || !host_ready()) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    boot_timing_mark(boot_stage_host_ready);
+
+    const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
+    if (ev != NULL && ev->state) {
+        /*
+         * Taken when the press is raised, not when its report goes out. It mostly tells how long
+         * the user waited to type, so it is only reported by the shell command.
+         */
+        boot_timing_mark(boot_stage_first_report);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(boot_timing, boot_timing_listener);
+ZMK_SUBSCRIPTION(boot_timing, zmk_keycode_state_changed);
+#if IS_ENABLED(CONFIG_ZMK_USB)
+ZMK_SUBSCRIPTION(boot_timing, zmk_usb_conn_state_changed);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+ZMK_SUBSCRIPTION(boot_timing, zmk_ble_active_profile_changed);
+#endif
+
+static int boot_timing_post_kernel(void) {
+    boot_timing_mark(boot_stage_post_kernel);
+    return 0;
+}
+
+/* ahead of every ZMK init at the default priority, including the display */
+static int boot_timing_application(void) {
+    boot_timing_mark(boot_stage_application);
+    return 0;
+}
+
+SYS_INIT(boot_timing_post_kernel, POST_KERNEL, 0);
+SYS_INIT(boot_timing_application, APPLICATION, 0);
+
+#if IS_ENABLED(CONFIG_SHELL)
+static int cmd_boot_timing(const struct shell *sh, size_t argc, char **argv) {
+    for (int i = 0; i < boot_stage_count; i++) {
+        int32_t ms = boot_timing_ms(i);
+        if (ms < 0) {
+            shell_print(sh, "%-16s -", stage_names[i]);
+        } else {
+            shell_print(sh, "%-16s %d ms", stage_names[i], ms);
+        }
+    }
+    return 0;
+}
+
+SHELL_CMD_REGISTER(boot_timing, NULL, "Uptime at each boot stage", cmd_boot_timing);
+#endif
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+/* milestones from power-up to the host being ready and the first key press after it */
+enum boot_stage {
+    boot_stage_post_kernel,
+    boot_stage_application,
+    /* status screen with its essential widgets is up */
+    boot_stage_screen,
+    /* every widget and page has been created */
+    boot_stage_screen_complete,
+    /* USB HID ready or the active BLE profile connected */
+    boot_stage_host_ready,
+    /* first key press after the host was ready */
+    boot_stage_first_report,
+    boot_stage_count,
+};
+
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_BOOT_TIMING)
+
+/* only the first mark of each stage counts, safe from any thread */
+void boot_timing_mark(enum boot_stage stage);
+
+/* uptime in ms at which the stage was reached, -1 if it has not been yet */
+int32_t boot_timing_ms(enum boot_stage stage);
+
+#else
+
+static inline void boot_timing_mark(enum boot_stage stage) {}
+static inline int32_t boot_timing_ms(enum boot_stage stage) { return -1; }
+
+#endif
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/devicetree.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <lvgl.h>
+
+#include <zmk/display.h>
+
+#include "display_monitor.h"
+
+#define SNAPSHOT_WIDTH DT_PROP(DT_CHOSEN(zephyr_display), width)
+#define SNAPSHOT_HEIGHT DT_PROP(DT_CHOSEN(zephyr_display), height)
+
+/* written by LVGL on the display work queue, read by the shell as a best-effort snapshot */
+struct display_monitor_stats {
+    uint32_t frames;
+    uint32_t last_ms;
+    uint32_t max_ms;
+    uint32_t last_px;
+    uint64_t total_px;
+};
+
+static struct display_monitor_stats stats;
+
+/* LVGL calls this after every refresh that flushed something, px counts the redrawn pixels */
+static void display_monitor_cb(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px) {
+    stats.frames++;
+    stats.last_ms = time_ms;
+    stats.max_ms = MAX(stats.max_ms, time_ms);
+    stats.last_px = px;
+    stats.total_px += px;
+}
+
+void display_monitor_attach(lv_disp_t *disp) {
+    if (disp != NULL) {
+        disp->driver->monitor_cb = display_monitor_cb;
+    }
+}
+
+/*
+ * The snapshot is rendered on the display work queue since LVGL is not thread safe, the shell
+ * waits for it and prints the result.
+ */
+static lv_color_t snapshot_buf[SNAPSHOT_WIDTH * SNAPSHOT_HEIGHT];
+static lv_img_dsc_t snapshot_dsc;
+static lv_res_t snapshot_res;
+static K_SEM_DEFINE(snapshot_done, 0, 1);
+
+static void snapshot_work_cb(struct k_work *work) {
+    snapshot_res = lv_snapshot_take_to_buf(lv_scr_act(), LV_IMG_CF_TRUE_COLOR, &snapshot_dsc,
+                                           snapshot_buf, sizeof(snapshot_buf));
+    k_sem_give(&snapshot_done);
+}
+
+static K_WORK_DEFINE(snapshot_work, snapshot_work_cb);
+
+/* plain PBM, so snapshots can be diffed as text and opened by any image viewer */
+static int cmd_display_snapshot(const struct shell *sh, size_t argc, char **argv) {
+    char row[SNAPSHOT_WIDTH + 1];
+
+    /* a snapshot that timed out earlier must not be taken for this one */
+    k_sem_reset(&snapshot_done);
+    k_work_submit_to_queue(zmk_display_work_q(), &snapshot_work);
+
+    if (k_sem_take(&snapshot_done, K_SECONDS(1)) < 0) {
+        struct k_work_sync sync;
+
+        /* keep the late work from filling the buffer while the next snapshot prints it */
+        k_work_cancel_sync(&snapshot_work, &sync);
+        shell_error(sh, "Snapshot timed out");
+        return -ETIMEDOUT;
+    }
+
+    if (snapshot_res != LV_RES_OK) {
+        shell_error(sh, "Snapshot failed");
+        return -EIO;
+    }
+
+    uint32_t width = snapshot_dsc.header.w;
+    uint32_t height = snapshot_dsc.header.h;
+
+    shell_print(sh, "P1");
+    shell_print(sh, "%u %u", width, height);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            /* PBM uses 1 for black */
+            row[x] = lv_color_to1(snapshot_buf[y * width + x]) ? '0' : '1';
+        }
+        row[width] = '\0';
+        shell_print(sh, "%s", row);
+    }
+
+    return 0;
+}
+
+static int cmd_display_stats(const struct shell *sh, size_t argc, char **argv) {
+    struct display_monitor_stats snapshot = stats;
+
+    shell_print(sh, "frames %u", snapshot.frames);
+    shell_print(sh, "render last %u ms max %u ms", snapshot.last_ms, snapshot.max_ms);
+    shell_print(sh, "redrawn last %u px total %llu px", snapshot.last_px, snapshot.total_px);
+    return 0;
+}
+
+static int cmd_display_reset(const struct shell *sh, size_t argc, char **argv) {
+    memset(&stats, 0, sizeof(stats));
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_display_monitor,
+                               SHELL_CMD(snapshot, NULL, "Print the screen as a PBM image",
+                                         cmd_display_snapshot),
+                               SHELL_CMD(stats, NULL, "Print render time and redrawn pixels",
+                                         cmd_display_stats),
+                               SHELL_CMD(reset, NULL, "Clear the render statistics",
+                                         cmd_display_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(display_monitor, &sub_display_monitor, "Status screen render monitor", NULL);
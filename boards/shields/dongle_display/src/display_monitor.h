@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_MONITOR)
+
+/* hook the render statistics into the display driver, call from the display work queue */
+void display_monitor_attach(lv_disp_t *disp);
+
+#else
+
+static inline void display_monitor_attach(lv_disp_t *disp) {}
+
+#endif
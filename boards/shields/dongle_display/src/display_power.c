@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <lvgl.h>
+
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/events/sensor_event.h>
+
+#include "../custom_status_screen.h"
+
+/*
+ * Steps the display down while the keyboard is idle. Every stage is a complete policy, so a
+ * wake from any stage restores the screen with a single transition.
+ */
+enum display_power_state {
+    display_power_active,
+    display_power_dim,
+    display_power_partial,
+    display_power_off,
+};
+
+struct display_power_policy {
+    /* enter this state once the keyboard has been idle this long */
+    uint32_t idle_ms;
+    uint8_t contrast;
+    /* LVGL refresh period, 0 stops refreshing altogether */
+    uint32_t refresh_ms;
+    bool animations;
+    bool minimal;
+    bool blank;
+};
+
+static const struct display_power_policy policies[] = {
+    [display_power_active] = {0, CONFIG_DONGLE_DISPLAY_POWER_ACTIVE_CONTRAST,
+                              LV_DISP_DEF_REFR_PERIOD, true, false, false},
+    [display_power_dim] = {CONFIG_DONGLE_DISPLAY_POWER_DIM_MS,
+                           CONFIG_DONGLE_DISPLAY_POWER_DIM_CONTRAST, 100, false, false, false},
+    [display_power_partial] = {CONFIG_DONGLE_DISPLAY_POWER_PARTIAL_MS,
+                               CONFIG_DONGLE_DISPLAY_POWER_DIM_CONTRAST, 1000, false, true, false},
+    [display_power_off] = {CONFIG_DONGLE_DISPLAY_POWER_OFF_MS,
+                           CONFIG_DONGLE_DISPLAY_POWER_DIM_CONTRAST, 0, false, true, true},
+};
+
+static const struct device *display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+
+static atomic_t power_state = ATOMIC_INIT(display_power_active);
+static atomic_t last_activity;
+
+static void set_refresh_period(uint32_t period_ms) {
+    lv_disp_t *disp = lv_disp_get_default();
+
+    if (disp == NULL || disp->refr_timer == NULL) {
+        return;
+    }
+
+    if (period_ms == 0) {
+        lv_timer_pause(disp->refr_timer);
+    } else {
+        lv_timer_set_period(disp->refr_timer, period_ms);
+        lv_timer_resume(disp->refr_timer);
+    }
+}
+
+static void apply_policy(enum display_power_state next) {
+    const struct display_power_policy *policy = &policies[next];
+
+    LOG_DBG("Display power %ld -> %d", atomic_get(&power_state), next);
+
+    if (policy->blank) {
+        display_blanking_on(display);
+    }
+
+    display_set_contrast(display, policy->contrast);
+    zmk_display_status_screen_set_animations(policy->animations);
+    zmk_display_status_screen_set_minimal(policy->minimal);
+    set_refresh_period(policy->refresh_ms);
+
+    if (!policy->blank) {
+        /* redraw with the new policy before the panel comes back */
+        lv_refr_now(NULL);
+        display_blanking_off(display);
+    }
+
+    atomic_set(&power_state, next);
+}
+
+static void display_power_work_cb(struct k_work *work);
+
+/* runs on the display work queue like everything else that touches LVGL */
+static K_WORK_DELAYABLE_DEFINE(display_power_work, display_power_work_cb);
+
+static void display_power_work_cb(struct k_work *work) {
+    uint32_t idle_ms = k_uptime_get_32() - (uint32_t)atomic_get(&last_activity);
+    enum display_power_state next = display_power_active;
+
+    while (next < display_power_off && idle_ms >= policies[next + 1].idle_ms) {
+        next++;
+    }
+
+    if (next != atomic_get(&power_state)) {
+        apply_policy(next);
+    }
+
+    if (next < display_power_off) {
+        k_work_schedule_for_queue(zmk_display_work_q(), &display_power_work,
+                                  K_MSEC(policies[next + 1].idle_ms - idle_ms));
+    }
+}
+
+/* any key press or encoder step, from either half, counts as activity */
+static int display_power_listener(const zmk_event_t *eh) {
+    atomic_set(&last_activity, k_uptime_get_32());
+
+    /* while active the pending stage timer re-checks the idle time itself */
+    if (atomic_get(&power_state) != display_power_active) {
+        k_work_reschedule_for_queue(zmk_display_work_q(), &display_power_work, K_NO_WAIT);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(display_power, display_power_listener);
+ZMK_SUBSCRIPTION(display_power, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(display_power, zmk_sensor_event);
+
+static int display_power_init(void) {
+    if (!device_is_ready(display)) {
+        LOG_ERR("Display device not ready, power manager disabled");
+        return -ENODEV;
+    }
+
+    atomic_set(&last_activity, k_uptime_get_32());
+
+    /* the display queue is running long before the first stage is due */
+    k_work_schedule_for_queue(zmk_display_work_q(), &display_power_work,
+                              K_MSEC(policies[display_power_dim].idle_ms));
+
+    return 0;
+}
+
+SYS_INIT(display_power_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+
+#include "display_render.h"
+#include "listener_profiler.h"
+
+/* only touched from the display work queue */
+static sys_slist_t mailboxes = SYS_SLIST_STATIC_INIT(&mailboxes);
+
+static void render_work_cb(struct k_work *work);
+
+/* backs off a tick so a preempted producer can finish its write */
+static K_WORK_DELAYABLE_DEFINE(render_retry_work, render_work_cb);
+
+static void render_work_cb(struct k_work *work) {
+    timing_t profile_start = listener_profiler_start();
+
+    bool retry = false;
+
+    struct dongle_widget_mailbox *mailbox;
+    SYS_SLIST_FOR_EACH_CONTAINER(&mailboxes, mailbox, node) {
+        if (atomic_cas(&mailbox->dirty, 1, 0) && !mailbox->apply()) {
+            /* raced with a producer that is mid-write, pick it up on the next pass */
+            atomic_set(&mailbox->dirty, 1);
+            retry = true;
+        }
+    }
+
+    if (retry) {
+        k_work_schedule_for_queue(zmk_display_work_q(), &render_retry_work, K_TICKS(1));
+    }
+
+    listener_profiler_stop("display_render", NULL, profile_start);
+}
+
+static K_WORK_DEFINE(render_work, render_work_cb);
+
+void dongle_display_render_register(struct dongle_widget_mailbox *mailbox) {
+    sys_slist_append(&mailboxes, &mailbox->node);
+}
+
+void dongle_display_render_request(struct dongle_widget_mailbox *mailbox) {
+    atomic_set(&mailbox->dirty, 1);
+    k_work_submit_to_queue(zmk_display_work_q(), &render_work);
+}
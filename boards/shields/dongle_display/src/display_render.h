@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/slist.h>
+
+/*
+ * Handoff point between a widget's state capture, which runs inline on the event thread, and
+ * its redraw, which runs on the display work queue. Requests coalesce: however many events
+ * arrive before the display queue gets to run, each dirty widget is redrawn once with its
+ * latest state.
+ */
+struct dongle_widget_mailbox {
+    sys_snode_t node;
+    atomic_t dirty;
+    /* returns false if the state could not be read consistently, the widget stays dirty */
+    bool (*apply)(void);
+};
+
+void dongle_display_render_register(struct dongle_widget_mailbox *mailbox);
+void dongle_display_render_request(struct dongle_widget_mailbox *mailbox);
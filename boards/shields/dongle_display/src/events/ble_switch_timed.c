@@ -0,0 +1,4 @@
+#include <zephyr/kernel.h>
+#include "ble_switch_timed.h"
+
+ZMK_EVENT_IMPL(zmk_ble_switch_timed);
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+struct zmk_ble_switch_timed {
+    uint8_t profile;
+    uint16_t ready_ms;
+    uint16_t first_key_ms;
+};
+
+ZMK_EVENT_DECLARE(zmk_ble_switch_timed);
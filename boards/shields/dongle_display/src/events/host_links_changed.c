@@ -0,0 +1,4 @@
+#include <zephyr/kernel.h>
+#include "host_links_changed.h"
+
+ZMK_EVENT_IMPL(zmk_host_links_changed);
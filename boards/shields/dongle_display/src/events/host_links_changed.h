@@ -0,0 +1,11 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+struct zmk_host_links_changed {
+    uint8_t connected;
+    uint8_t weak;
+};
+
+ZMK_EVENT_DECLARE(zmk_host_links_changed);
@@ -0,0 +1,4 @@
+#include <zephyr/kernel.h>
+#include "usb_hid_rate_changed.h"
+
+ZMK_EVENT_IMPL(zmk_usb_hid_rate_changed);
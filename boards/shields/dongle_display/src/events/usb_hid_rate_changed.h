@@ -0,0 +1,10 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+struct zmk_usb_hid_rate_changed {
+    uint16_t reports_per_sec;
+};
+
+ZMK_EVENT_DECLARE(zmk_usb_hid_rate_changed);
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "glyph_blit.h"
+
+/* indexed canvases keep their palette in front of the pixels */
+#define GLYPH_LABEL_PALETTE_SIZE (sizeof(lv_color32_t) * 2)
+
+static const struct glyph_subset_glyph *glyph_subset_find(const struct glyph_subset *font,
+                                                          uint32_t codepoint) {
+    int lo = 0, hi = font->count - 1;
+
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        uint32_t cp = font->glyphs[mid].codepoint;
+
+        if (cp == codepoint) {
+            return &font->glyphs[mid];
+        }
+        if (cp < codepoint) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    return NULL;
+}
+
+static lv_coord_t glyph_text_width(const struct glyph_subset *font, const char *text) {
+    lv_coord_t width = 0;
+
+    for (const char *c = text; *c != '\0'; c++) {
+        const struct glyph_subset_glyph *glyph = glyph_subset_find(font, (uint8_t)*c);
+        if (glyph != NULL) {
+            width += glyph->adv;
+        }
+    }
+
+    return width;
+}
+
+/* OR one glyph into the pixel rows, shifting each source byte across two destination bytes */
+static void blit_glyph(uint8_t *pixels, lv_coord_t stride, lv_coord_t height,
+                       const struct glyph_subset *font, const struct glyph_subset_glyph *glyph,
+                       lv_coord_t x) {
+    lv_coord_t top = font->line_height - font->base_line - glyph->box_h - glyph->ofs_y;
+    lv_coord_t left = x + glyph->ofs_x;
+    uint8_t src_stride = (glyph->box_w + 7) / 8;
+    const uint8_t *src = font->bitmap + glyph->bitmap_index;
+
+    for (int row = 0; row < glyph->box_h; row++, src += src_stride) {
+        lv_coord_t y = top + row;
+        if (y < 0 || y >= height) {
+            continue;
+        }
+
+        uint8_t *dst = pixels + y * stride;
+
+        for (int i = 0; i < src_stride; i++) {
+            lv_coord_t x0 = left + i * 8;
+            uint8_t bits = src[i];
+
+            if (x0 < 0) {
+                if (x0 <= -8) {
+                    continue;
+                }
+                bits <<= -x0;
+                x0 = 0;
+            }
+
+            lv_coord_t idx = x0 >> 3;
+            uint8_t shift = x0 & 7;
+
+            if (idx < stride) {
+                dst[idx] |= bits >> shift;
+            }
+            if (shift != 0 && idx + 1 < stride) {
+                dst[idx + 1] |= bits << (8 - shift);
+            }
+        }
+    }
+}
+
+void glyph_label_init(struct glyph_label *label, lv_obj_t *parent,
+                      const struct glyph_subset *font, uint8_t *buf, lv_coord_t width,
+                      lv_text_align_t align) {
+    label->obj = lv_canvas_create(parent);
+    label->font = font;
+    label->buf = buf;
+    label->width = width;
+    label->align = align;
+
+    lv_canvas_set_buffer(label->obj, buf, width, font->line_height, LV_IMG_CF_INDEXED_1BIT);
+    lv_canvas_set_palette(label->obj, 0, lv_color_white());
+    lv_canvas_set_palette(label->obj, 1, lv_color_black());
+
+    glyph_label_set_text(label, "");
+}
+
+void glyph_label_set_text(struct glyph_label *label, const char *text) {
+    lv_coord_t stride = (label->width + 7) / 8;
+    lv_coord_t height = label->font->line_height;
+    uint8_t *pixels = label->buf + GLYPH_LABEL_PALETTE_SIZE;
+    lv_coord_t x = 0;
+
+    memset(pixels, 0, stride * height);
+
+    if (label->align == LV_TEXT_ALIGN_RIGHT) {
+        x = MAX(label->width - glyph_text_width(label->font, text), 0);
+    } else if (label->align == LV_TEXT_ALIGN_CENTER) {
+        x = MAX((label->width - glyph_text_width(label->font, text)) / 2, 0);
+    }
+
+    for (const char *c = text; *c != '\0' && x < label->width; c++) {
+        const struct glyph_subset_glyph *glyph = glyph_subset_find(label->font, (uint8_t)*c);
+        if (glyph == NULL) {
+            LOG_WRN("No glyph for '%c', regenerate the glyph subsets", *c);
+            continue;
+        }
+
+        blit_glyph(pixels, stride, height, label->font, glyph, x);
+        x += glyph->adv;
+    }
+
+    lv_obj_invalidate(label->obj);
+}
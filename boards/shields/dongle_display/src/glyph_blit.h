@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+/*
+ * 1-bpp glyph subsets generated at build time by scripts/gen_glyph_subsets.py. Glyph rows are
+ * padded to whole bytes and placed like LVGL places them, relative to line_height/base_line.
+ */
+struct glyph_subset_glyph {
+    uint32_t codepoint;
+    uint16_t bitmap_index;
+    uint8_t adv;
+    uint8_t box_w;
+    uint8_t box_h;
+    int8_t ofs_x;
+    int8_t ofs_y;
+};
+
+struct glyph_subset {
+    uint8_t line_height;
+    uint8_t base_line;
+    uint16_t count;
+    /* sorted by codepoint */
+    const struct glyph_subset_glyph *glyphs;
+    const uint8_t *bitmap;
+};
+
+/*
+ * A single line of text on a 1-bpp indexed canvas. Text is blitted straight into the canvas
+ * buffer, bypassing LVGL's label layout and glyph rendering.
+ */
+struct glyph_label {
+    lv_obj_t *obj;
+    const struct glyph_subset *font;
+    uint8_t *buf;
+    lv_coord_t width;
+    lv_text_align_t align;
+};
+
+#define GLYPH_LABEL_BUF_SIZE(w, h) LV_CANVAS_BUF_SIZE_INDEXED_1BIT(w, h)
+
+void glyph_label_init(struct glyph_label *label, lv_obj_t *parent,
+                      const struct glyph_subset *font, uint8_t *buf, lv_coord_t width,
+                      lv_text_align_t align);
+void glyph_label_set_text(struct glyph_label *label, const char *text);
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/ble.h>
+#include <zmk/event_manager.h>
+
+#include "host_links.h"
+#include "events/host_links_changed.h"
+
+BUILD_ASSERT(ZMK_BLE_PROFILE_COUNT <= 8, "Host link masks hold at most eight profiles");
+
+/*
+ * Tracks every host the dongle is connected to, not just the active profile. ZMK keeps the
+ * links to inactive profiles open, so this is what decides whether a profile switch is instant.
+ * `links` is only touched from the system work queue. The RSSI reads wait for an HCI round
+ * trip, so they run on their own low priority queue and hand the result over.
+ */
+static struct zmk_host_links links;
+
+static struct zmk_host_links polled;
+static struct k_spinlock polled_lock;
+
+static K_THREAD_STACK_DEFINE(host_links_stack, CONFIG_DONGLE_DISPLAY_HOST_LINKS_STACK_SIZE);
+static struct k_work_q host_links_q;
+
+struct zmk_host_links zmk_host_links_get(void) { return links; }
+
+static int read_rssi(struct bt_conn *conn, int8_t *rssi) {
+    struct bt_hci_cp_read_rssi *cp;
+    struct bt_hci_rp_read_rssi *rp;
+    struct net_buf *buf, *rsp;
+    uint16_t handle;
+
+    int err = bt_hci_get_conn_handle(conn, &handle);
+    if (err < 0) {
+        return err;
+    }
+
+    buf = bt_hci_cmd_create(BT_HCI_OP_READ_RSSI, sizeof(*cp));
+    if (buf == NULL) {
+        return -ENOBUFS;
+    }
+
+    cp = net_buf_add(buf, sizeof(*cp));
+    cp->handle = sys_cpu_to_le16(handle);
+
+    /* takes over buf, and only hands out rsp on success */
+    err = bt_hci_cmd_send_sync(BT_HCI_OP_READ_RSSI, buf, &rsp);
+    if (err < 0) {
+        return err;
+    }
+
+    rp = (void *)rsp->data;
+    if (rp->status != 0) {
+        err = -EIO;
+    } else {
+        *rssi = rp->rssi;
+    }
+
+    net_buf_unref(rsp);
+    return err;
+}
+
+struct host_conns {
+    struct bt_conn *conns[ZMK_BLE_PROFILE_COUNT];
+    int index[ZMK_BLE_PROFILE_COUNT];
+    int count;
+};
+
+static void collect_host_conn(struct bt_conn *conn, void *data) {
+    struct host_conns *hosts = data;
+    struct bt_conn_info info;
+
+    /* the dongle is central towards the halves and peripheral towards the hosts */
+    if (hosts->count >= ARRAY_SIZE(hosts->conns) || bt_conn_get_info(conn, &info) < 0 ||
+        info.role != BT_CONN_ROLE_PERIPHERAL || info.state != BT_CONN_STATE_CONNECTED) {
+        return;
+    }
+
+    int index = zmk_ble_profile_index(bt_conn_get_dst(conn));
+    if (index < 0 || index >= ZMK_BLE_PROFILE_COUNT) {
+        return;
+    }
+
+    hosts->conns[hosts->count] = bt_conn_ref(conn);
+    hosts->index[hosts->count] = index;
+    hosts->count++;
+}
+
+static void host_links_publish_cb(struct k_work *work) {
+    struct zmk_host_links next;
+
+    K_SPINLOCK(&polled_lock) { next = polled; }
+
+    if (next.connected == links.connected && next.weak == links.weak) {
+        return;
+    }
+
+    links = next;
+    raise_zmk_host_links_changed(
+        (struct zmk_host_links_changed){.connected = next.connected, .weak = next.weak});
+}
+
+static K_WORK_DEFINE(host_links_publish, host_links_publish_cb);
+
+/* runs on host_links_q, never on the system work queue */
+static void host_links_poll_cb(struct k_work *work) {
+    struct host_conns hosts = {0};
+    struct zmk_host_links next = {0};
+
+    /* only take references here, the HCI commands must not run inside the foreach */
+    bt_conn_foreach(BT_CONN_TYPE_LE, collect_host_conn, &hosts);
+
+    for (int i = 0; i < hosts.count; i++) {
+        int8_t rssi;
+
+        next.connected |= BIT(hosts.index[i]);
+        if (read_rssi(hosts.conns[i], &rssi) == 0 &&
+            rssi < CONFIG_DONGLE_DISPLAY_HOST_LINKS_WEAK_RSSI) {
+            next.weak |= BIT(hosts.index[i]);
+        }
+
+        bt_conn_unref(hosts.conns[i]);
+    }
+
+    if (next.connected != 0) {
+        /* RSSI drifts, keep sampling while any host is connected */
+        k_work_schedule_for_queue(&host_links_q, k_work_delayable_from_work(work),
+                                  K_MSEC(CONFIG_DONGLE_DISPLAY_HOST_LINKS_POLL_MS));
+    }
+
+    K_SPINLOCK(&polled_lock) { polled = next; }
+    k_work_submit(&host_links_publish);
+}
+
+static K_WORK_DELAYABLE_DEFINE(host_links_poll, host_links_poll_cb);
+
+static void host_links_connected(struct bt_conn *conn, uint8_t err) {
+    if (err == 0) {
+        k_work_reschedule_for_queue(&host_links_q, &host_links_poll, K_NO_WAIT);
+    }
+}
+
+static void host_links_disconnected(struct bt_conn *conn, uint8_t reason) {
+    k_work_reschedule_for_queue(&host_links_q, &host_links_poll, K_NO_WAIT);
+}
+
+BT_CONN_CB_DEFINE(host_links_conn_callbacks) = {
+    .connected = host_links_connected,
+    .disconnected = host_links_disconnected,
+};
+
+static int host_links_init(void) {
+    k_work_queue_init(&host_links_q);
+    k_work_queue_start(&host_links_q, host_links_stack, K_THREAD_STACK_SIZEOF(host_links_stack),
+                       CONFIG_DONGLE_DISPLAY_HOST_LINKS_THREAD_PRIORITY, NULL);
+    k_thread_name_set(&host_links_q.thread, "host_links");
+    return 0;
+}
+
+SYS_INIT(host_links_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
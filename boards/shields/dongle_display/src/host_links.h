@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+/* one bit per BLE profile */
+struct zmk_host_links {
+    /* profiles whose host is connected right now */
+    uint8_t connected;
+    /* connected profiles whose RSSI is below the weak link threshold */
+    uint8_t weak;
+};
+
+struct zmk_host_links zmk_host_links_get(void);
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/keymap.h>
+
+#include "layer_cache.h"
+
+struct layer_cache {
+    zmk_keymap_layers_state_t state;
+    zmk_keymap_layer_id_t highest;
+    const char *name;
+    bool valid;
+};
+
+static struct layer_cache cache;
+
+static void layer_cache_refresh(void) {
+    zmk_keymap_layers_state_t state = zmk_keymap_layer_state();
+
+    if (cache.valid && cache.state == state) {
+        return;
+    }
+
+    /*
+     * Conditional layers raise one layer_state_changed per cascaded layer; only the mask
+     * that is live when we get asked is worth resolving.
+     */
+    zmk_keymap_layer_id_t highest = zmk_keymap_highest_layer_active();
+    if (!cache.valid || highest != cache.highest) {
+        cache.name = zmk_keymap_layer_name(highest);
+    }
+
+    cache.state = state;
+    cache.highest = highest;
+    cache.valid = true;
+}
+
+zmk_keymap_layer_id_t zmk_layer_cache_highest_active(void) {
+    layer_cache_refresh();
+    return cache.highest;
+}
+
+const char *zmk_layer_cache_highest_name(void) {
+    layer_cache_refresh();
+    return cache.name;
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zmk/keymap.h>
+
+/*
+ * Highest active layer and its name, recomputed only when the layer state mask changes.
+ * Repeated lookups while the mask is unchanged are a single compare and two reads.
+ */
+zmk_keymap_layer_id_t zmk_layer_cache_highest_active(void);
+const char *zmk_layer_cache_highest_name(void);
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if IS_ENABLED(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+#include <zmk/event_manager.h>
+
+#include "listener_profiler.h"
+
+/* bucket 0 is < 1 us, bucket n is [2^(n-1), 2^n) us, the last one collects everything above */
+#define PROFILE_BUCKETS 16
+
+struct listener_profile {
+    const char *listener;
+    const struct zmk_event_type *event;
+    uint32_t count;
+    uint32_t max_us;
+    uint32_t hist[PROFILE_BUCKETS];
+};
+
+static struct listener_profile profiles[CONFIG_DONGLE_DISPLAY_LISTENER_PROFILER_SLOTS];
+static uint8_t profiles_used;
+static uint32_t profiles_dropped;
+static struct k_spinlock profiles_lock;
+
+static struct listener_profile *find_profile(const char *listener,
+                                             const struct zmk_event_type *event) {
+    for (int i = 0; i < profiles_used; i++) {
+        if (profiles[i].listener == listener && profiles[i].event == event) {
+            return &profiles[i];
+        }
+    }
+
+    if (profiles_used == ARRAY_SIZE(profiles)) {
+        return NULL;
+    }
+
+    struct listener_profile *profile = &profiles[profiles_used++];
+    profile->listener = listener;
+    profile->event = event;
+    return profile;
+}
+
+timing_t listener_profiler_start(void) { return timing_counter_get(); }
+
+void listener_profiler_stop(const char *listener, const zmk_event_t *eh, timing_t start) {
+    timing_t end = timing_counter_get();
+    uint32_t us = (uint32_t)(timing_cycles_to_ns(timing_cycles_get(&start, &end)) / 1000);
+    uint8_t bucket = MIN(find_msb_set(us), PROFILE_BUCKETS - 1);
+
+    K_SPINLOCK(&profiles_lock) {
+        struct listener_profile *profile =
+            find_profile(listener, eh != NULL ? eh->event : NULL);
+        if (profile == NULL) {
+            profiles_dropped++;
+            K_SPINLOCK_BREAK;
+        }
+
+        profile->count++;
+        profile->max_us = MAX(profile->max_us, us);
+        profile->hist[bucket]++;
+    }
+}
+
+void listener_profiler_reset(void) {
+    K_SPINLOCK(&profiles_lock) {
+        memset(profiles, 0, sizeof(profiles));
+        profiles_used = 0;
+        profiles_dropped = 0;
+    }
+}
+
+static void format_histogram(const struct listener_profile *profile, char *buf, size_t len) {
+    int pos = 0;
+    for (int i = 0; i < PROFILE_BUCKETS && pos < len; i++) {
+        pos += snprintf(buf + pos, len - pos, "%s%u", i ? " " : "", profile->hist[i]);
+    }
+}
+
+void listener_profiler_dump(void) {
+    char hist[PROFILE_BUCKETS * 6];
+
+    for (int i = 0; i < profiles_used; i++) {
+        struct listener_profile profile = profiles[i];
+        format_histogram(&profile, hist, sizeof(hist));
+        LOG_INF("%s/%s n=%u max=%uus log2(us): %s", profile.listener,
+                profile.event ? profile.event->name : "-", profile.count, profile.max_us,
+                hist);
+    }
+    if (profiles_dropped) {
+        LOG_WRN("%u samples dropped, raise DONGLE_DISPLAY_LISTENER_PROFILER_SLOTS",
+                profiles_dropped);
+    }
+}
+
+#if CONFIG_DONGLE_DISPLAY_LISTENER_PROFILER_LOG_INTERVAL_MS > 0
+static void profiler_log_cb(struct k_work *work) {
+    listener_profiler_dump();
+    k_work_schedule(k_work_delayable_from_work(work),
+                    K_MSEC(CONFIG_DONGLE_DISPLAY_LISTENER_PROFILER_LOG_INTERVAL_MS));
+}
+
+static K_WORK_DELAYABLE_DEFINE(profiler_log_work, profiler_log_cb);
+#endif
+
+static int listener_profiler_init(void) {
+    timing_init();
+    timing_start();
+
+#if CONFIG_DONGLE_DISPLAY_LISTENER_PROFILER_LOG_INTERVAL_MS > 0
+    k_work_schedule(&profiler_log_work,
+                    K_MSEC(CONFIG_DONGLE_DISPLAY_LISTENER_PROFILER_LOG_INTERVAL_MS));
+#endif
+
+    return 0;
+}
+
+SYS_INIT(listener_profiler_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#if IS_ENABLED(CONFIG_SHELL)
+static int cmd_listener_prof_dump(const struct shell *sh, size_t argc, char **argv) {
+    char hist[PROFILE_BUCKETS * 6];
+
+    for (int i = 0; i < profiles_used; i++) {
+        struct listener_profile profile = profiles[i];
+        format_histogram(&profile, hist, sizeof(hist));
+        shell_print(sh, "%-32s %-32s n=%-6u max=%-6uus %s", profile.listener,
+                    profile.event ? profile.event->name : "-", profile.count,
+                    profile.max_us, hist);
+    }
+    return 0;
+}
+
+static int cmd_listener_prof_reset(const struct shell *sh, size_t argc, char **argv) {
+    listener_profiler_reset();
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_listener_prof,
+                               SHELL_CMD(dump, NULL, "Print latency histograms",
+                                         cmd_listener_prof_dump),
+                               SHELL_CMD(reset, NULL, "Clear all histograms",
+                                         cmd_listener_prof_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(listener_prof, &sub_listener_prof, "Event listener latency profiler", NULL);
+#endif
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/timing/timing.h>
+#include <zmk/event_manager.h>
+
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_LISTENER_PROFILER)
+
+timing_t listener_profiler_start(void);
+void listener_profiler_stop(const char *listener, const zmk_event_t *eh, timing_t start);
+void listener_profiler_dump(void);
+void listener_profiler_reset(void);
+
+#else
+
+static inline timing_t listener_profiler_start(void) { return 0; }
+static inline void listener_profiler_stop(const char *listener, const zmk_event_t *eh,
+                                          timing_t start) {}
+static inline void listener_profiler_dump(void) {}
+static inline void listener_profiler_reset(void) {}
+
+#endif
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/activity.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+
+#include "settings_writeback.h"
+
+#define WRITEBACK_MAX_DELAY_MS (CONFIG_DONGLE_DISPLAY_SETTINGS_WRITEBACK_MAX_DELAY_S * MSEC_PER_SEC)
+#define WRITEBACK_MIN_INTERVAL_MS                                                                  \
+    (CONFIG_DONGLE_DISPLAY_SETTINGS_WRITEBACK_MIN_INTERVAL_S * MSEC_PER_SEC)
+
+struct writeback_entry {
+    const char *key;
+    const void *value;
+    size_t len;
+    bool dirty;
+    /* uptime before which the key is not written again, bounds the erase rate per key */
+    int64_t next_write;
+};
+
+static struct writeback_entry entries[CONFIG_DONGLE_DISPLAY_SETTINGS_WRITEBACK_SLOTS];
+static struct k_spinlock entries_lock;
+
+/* oldest unwritten save, bounds how long a steady stream of saves can postpone the write */
+static bool pending;
+static int64_t pending_since;
+
+/* serializes the writeback thread with a flush on the caller's thread, guards staging */
+static K_MUTEX_DEFINE(write_lock);
+static uint8_t staging[CONFIG_DONGLE_DISPLAY_SETTINGS_WRITEBACK_BUF_SIZE];
+
+static K_THREAD_STACK_DEFINE(writeback_stack, CONFIG_DONGLE_DISPLAY_SETTINGS_WRITEBACK_STACK_SIZE);
+static struct k_work_q writeback_q;
+
+static void writeback_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(writeback_work, writeback_work_cb);
+
+static struct writeback_entry *find_entry(const char *key) {
+    struct writeback_entry *unused = NULL;
+
+    for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+        if (entries[i].key == NULL) {
+            unused = unused ? unused : &entries[i];
+        } else if (entries[i].key == key || strcmp(entries[i].key, key) == 0) {
+            return &entries[i];
+        }
+    }
+
+    return unused;
+}
+
+static bool take_dirty(struct writeback_entry *entry, bool force, int64_t now, const char **key,
+                       size_t *len, int64_t *retry_at) {
+    bool take = false;
+
+    /*
+     * Callers update their values from the system work queue without locking. The spinlock
+     * masks interrupts, so nothing can preempt the copy and the staged value is consistent.
+     */
+    K_SPINLOCK(&entries_lock) {
+        if (!entry->dirty) {
+            K_SPINLOCK_BREAK;
+        }
+
+        if (!force && now < entry->next_write) {
+            *retry_at = MIN(*retry_at, entry->next_write);
+            K_SPINLOCK_BREAK;
+        }
+
+        take = true;
+        entry->dirty = false;
+        entry->next_write = now + WRITEBACK_MIN_INTERVAL_MS;
+        *key = entry->key;
+        *len = entry->len;
+        memcpy(staging, entry->value, entry->len);
+    }
+
+    return take;
+}
+
+/* returns the uptime at which keys held back by their minimum interval are due, or INT64_MAX */
+static int64_t write_dirty(bool force, int64_t now) {
+    int64_t retry_at = INT64_MAX;
+
+    K_SPINLOCK(&entries_lock) { pending = false; }
+
+    k_mutex_lock(&write_lock, K_FOREVER);
+
+    for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+        const char *key;
+        size_t len;
+
+        if (!take_dirty(&entries[i], force, now, &key, &len, &retry_at)) {
+            continue;
+        }
+
+        /* the erase can take tens of milliseconds, key processing carries on meanwhile */
+        int err = settings_save_one(key, staging, len);
+        if (err < 0) {
+            LOG_ERR("Failed to write %s (%d), retrying later", key, err);
+            settings_writeback_save(key, entries[i].value, len);
+        }
+    }
+
+    k_mutex_unlock(&write_lock);
+
+    return retry_at;
+}
+
+static void writeback_work_cb(struct k_work *work) {
+    int64_t now = k_uptime_get();
+    int64_t retry_at = write_dirty(false, now);
+
+    /* keys written too recently stay dirty until their interval is up */
+    if (retry_at != INT64_MAX) {
+        k_work_reschedule_for_queue(&writeback_q, &writeback_work, K_MSEC(retry_at - now));
+    }
+}
+
+int settings_writeback_save(const char *key, const void *value, size_t len) {
+    int64_t now = k_uptime_get();
+    int64_t delay = CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE;
+    int err = 0;
+
+    if (len > sizeof(staging)) {
+        return -ENOMEM;
+    }
+
+    K_SPINLOCK(&entries_lock) {
+        struct writeback_entry *entry = find_entry(key);
+        if (entry == NULL) {
+            err = -ENOSPC;
+            K_SPINLOCK_BREAK;
+        }
+
+        entry->key = key;
+        entry->value = value;
+        entry->len = len;
+        entry->dirty = true;
+
+        if (!pending) {
+            pending = true;
+            pending_since = now;
+        }
+        delay = MIN(delay, pending_since + WRITEBACK_MAX_DELAY_MS - now);
+    }
+
+    if (err < 0) {
+        LOG_ERR("No writeback slot for %s, raise DONGLE_DISPLAY_SETTINGS_WRITEBACK_SLOTS", key);
+        return err;
+    }
+
+    k_work_reschedule_for_queue(&writeback_q, &writeback_work, K_MSEC(MAX(delay, 0)));
+    return 0;
+}
+
+void settings_writeback_flush(void) {
+    k_work_cancel_delayable(&writeback_work);
+    write_dirty(true, k_uptime_get());
+}
+
+static int settings_writeback_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+
+    /*
+     * ZMK powers off right after raising the sleep event, so write on this thread before
+     * returning. Idle alone is not worth an erase.
+     */
+    if (ev != NULL && ev->state == ZMK_ACTIVITY_SLEEP) {
+        settings_writeback_flush();
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(settings_writeback, settings_writeback_listener);
+ZMK_SUBSCRIPTION(settings_writeback, zmk_activity_state_changed);
+
+static int settings_writeback_init(void) {
+    k_work_queue_init(&writeback_q);
+    k_work_queue_start(&writeback_q, writeback_stack, K_THREAD_STACK_SIZEOF(writeback_stack),
+                       CONFIG_DONGLE_DISPLAY_SETTINGS_WRITEBACK_THREAD_PRIORITY, NULL);
+    k_thread_name_set(&writeback_q.thread, "settings_writeback");
+    return 0;
+}
+
+SYS_INIT(settings_writeback_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+/*
+ * Write-back cache in front of settings_save_one(). A save only marks the key dirty, the value
+ * is copied and written from a low priority thread once writes to any key have been quiet for
+ * ZMK_SETTINGS_SAVE_DEBOUNCE, at the latest after the maximum delay, or when the keyboard goes
+ * to sleep. Repeated saves of the same key in between cost a single flash write, and apart from
+ * the sleep flush a key is written at most once per minimum interval. Without sleep, as on the
+ * dongle, an unplug or reset loses up to the larger of the maximum delay and the minimum
+ * interval of saves.
+ *
+ * The value must stay valid until it is written, callers pass their long lived RAM copy.
+ */
+int settings_writeback_save(const char *key, const void *value, size_t len);
+
+/* write all dirty keys on the calling thread, ignoring the minimum interval, e.g. before a reset */
+void settings_writeback_flush(void);
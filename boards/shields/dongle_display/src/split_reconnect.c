@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/addr.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/ble.h>
+#include <zmk/event_manager.h>
+
+#include "split_reconnect.h"
+#include "events/split_central_status_changed.h"
+
+#define PERIPHERAL_ADDRS_SETTINGS_KEY "ble/peripheral_addresses"
+
+/* the BT RX thread only queues link changes, the work item below handles them */
+struct link_change {
+    bt_addr_le_t addr;
+    int64_t at;
+    bool connected;
+};
+
+K_MSGQ_DEFINE(link_changes, sizeof(struct link_change), 2 * ZMK_SPLIT_BLE_PERIPHERAL_COUNT, 4);
+
+/* only touched from the system work queue */
+static bt_addr_le_t peripheral_addrs[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+static int64_t down_since[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+
+static atomic_t reconnect_ms[ZMK_SPLIT_BLE_PERIPHERAL_COUNT] = {
+    [0 ... ZMK_SPLIT_BLE_PERIPHERAL_COUNT - 1] = ATOMIC_INIT(-1)};
+
+int32_t split_reconnect_ms(uint8_t slot) {
+    return slot < ZMK_SPLIT_BLE_PERIPHERAL_COUNT ? (int32_t)atomic_get(&reconnect_ms[slot]) : -1;
+}
+
+static int peripheral_addr_load(const char *key, size_t len, settings_read_cb read_cb,
+                                void *cb_arg, void *param) {
+    const char *next;
+
+    if (key == NULL || settings_name_next(key, &next) == 0 || next != NULL) {
+        return 0;
+    }
+
+    int slot = atoi(key);
+    if (slot < 0 || slot >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT || len != sizeof(bt_addr_le_t)) {
+        return 0;
+    }
+
+    int err = read_cb(cb_arg, &peripheral_addrs[slot], sizeof(bt_addr_le_t));
+    return err < 0 ? err : 0;
+}
+
+/*
+ * ZMK stores the address of each bonded half under its slot when pairing, so the same slot is
+ * reported here and by the battery events. A miss means a half was bonded since the last read.
+ */
+static int peripheral_slot(const bt_addr_le_t *addr) {
+    for (int retry = 0; retry < 2; retry++) {
+        for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+            if (bt_addr_le_cmp(addr, &peripheral_addrs[i]) == 0) {
+                return i;
+            }
+        }
+
+        int err = settings_load_subtree_direct(PERIPHERAL_ADDRS_SETTINGS_KEY,
+                                               peripheral_addr_load, NULL);
+        if (err < 0) {
+            LOG_ERR("Failed to read the peripheral addresses (%d)", err);
+            break;
+        }
+    }
+
+    return -ENOENT;
+}
+
+static void split_reconnect_work_cb(struct k_work *work) {
+    struct link_change change;
+
+    while (k_msgq_get(&link_changes, &change, K_NO_WAIT) == 0) {
+        int slot = peripheral_slot(&change.addr);
+        if (slot < 0) {
+            continue;
+        }
+
+        if (change.connected) {
+            atomic_set(&reconnect_ms[slot], change.at - down_since[slot]);
+            LOG_INF("Peripheral %d reconnected after %d ms", slot, split_reconnect_ms(slot));
+        } else {
+            down_since[slot] = change.at;
+        }
+
+        raise_zmk_split_central_status_changed(
+            (struct zmk_split_central_status_changed){.slot = slot, .connected = change.connected});
+    }
+}
+
+static K_WORK_DEFINE(split_reconnect_work, split_reconnect_work_cb);
+
+static void queue_link_change(struct bt_conn *conn, bool connected) {
+    struct bt_conn_info info;
+
+    /* the dongle is central only towards the halves */
+    if (bt_conn_get_info(conn, &info) < 0 || info.role != BT_CONN_ROLE_CENTRAL) {
+        return;
+    }
+
+    struct link_change change = {.at = k_uptime_get(), .connected = connected};
+    bt_addr_le_copy(&change.addr, bt_conn_get_dst(conn));
+
+    if (k_msgq_put(&link_changes, &change, K_NO_WAIT) < 0) {
+        LOG_WRN("Dropped a peripheral link change");
+        return;
+    }
+
+    k_work_submit(&split_reconnect_work);
+}
+
+static void split_reconnect_connected(struct bt_conn *conn, uint8_t err) {
+    if (err != 0) {
+        return;
+    }
+
+    queue_link_change(conn, true);
+}
+
+static void split_reconnect_disconnected(struct bt_conn *conn, uint8_t reason) {
+    queue_link_change(conn, false);
+}
+
+BT_CONN_CB_DEFINE(split_reconnect_conn_callbacks) = {
+    .connected = split_reconnect_connected,
+    .disconnected = split_reconnect_disconnected,
+};
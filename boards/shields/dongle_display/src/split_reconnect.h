@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+/*
+ * Per peripheral slot, how long the last reconnect took from the link dropping until it was
+ * back up, -1 before the first reconnect. The first connection after boot counts from uptime 0.
+ */
+int32_t split_reconnect_ms(uint8_t slot);
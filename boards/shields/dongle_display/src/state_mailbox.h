@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+
+/*
+ * Latest-value-wins mailbox for any number of producers and one consumer, guarded by a
+ * sequence counter. Widget state is put from the system work queue, the BT RX thread and the
+ * display queue when a widget is created, so producers copy under a spinlock and never
+ * interleave. Inside it a producer bumps the counter to odd, copies the value and bumps it
+ * back to even. The consumer takes no lock: it copies the value out and accepts it only if the
+ * counter was even and did not move meanwhile. A consumer that keeps losing the race gives up
+ * instead of spinning, since it may have preempted a producer; it simply picks up a newer value
+ * on its next pass.
+ */
+#define STATE_MAILBOX_READ_ATTEMPTS 4
+
+#define STATE_MAILBOX(type)                                                                        \
+    struct {                                                                                       \
+        struct k_spinlock lock;                                                                    \
+        atomic_t seq;                                                                              \
+        type value;                                                                                \
+    }
+
+static inline void state_mailbox_put(struct k_spinlock *lock, atomic_t *seq, void *slot,
+                                     const void *value, size_t size) {
+    K_SPINLOCK(lock) {
+        atomic_inc(seq);
+        barrier_dmem_fence_full();
+        memcpy(slot, value, size);
+        barrier_dmem_fence_full();
+        atomic_inc(seq);
+    }
+}
+
+static inline bool state_mailbox_get(const atomic_t *seq, const void *slot, void *value,
+                                     size_t size) {
+    for (int i = 0; i < STATE_MAILBOX_READ_ATTEMPTS; i++) {
+        atomic_val_t begin = atomic_get(seq);
+        if (begin & 1) {
+            continue;
+        }
+
+        barrier_dmem_fence_full();
+        memcpy(value, slot, size);
+        barrier_dmem_fence_full();
+
+        if (atomic_get(seq) == begin) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#define STATE_MAILBOX_PUT(mailbox, val)                                                            \
+    state_mailbox_put(&(mailbox)->lock, &(mailbox)->seq, &(mailbox)->value, &(val),                \
+                      sizeof((mailbox)->value))
+
+#define STATE_MAILBOX_GET(mailbox, val)                                                            \
+    state_mailbox_get(&(mailbox)->seq, &(mailbox)->value, &(val), sizeof((mailbox)->value))
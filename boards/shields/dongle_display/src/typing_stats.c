@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if IS_ENABLED(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+#include <zmk/event_manager.h>
+#include <zmk/events/layer_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/events/wpm_state_changed.h>
+#include <zmk/keymap.h>
+#include <zmk/matrix.h>
+
+#include "layer_cache.h"
+#include "settings_writeback.h"
+#include "typing_stats.h"
+
+#define STATS_SETTINGS_KEY "dongle_stats/v1"
+
+/* stored as a single blob, bump the key version when the layout changes */
+struct typing_stats_record {
+    uint32_t presses[ZMK_KEYMAP_LEN];
+    uint64_t layer_dwell_ms[ZMK_KEYMAP_LAYERS_LEN];
+    uint32_t wpm_sum;
+    uint32_t wpm_samples;
+    uint8_t peak_wpm;
+};
+
+static struct typing_stats_record stats;
+
+BUILD_ASSERT(sizeof(stats) <= CONFIG_DONGLE_DISPLAY_SETTINGS_WRITEBACK_BUF_SIZE,
+             "Typing stats do not fit the settings writeback buffer");
+
+/* only touched from the event thread */
+static zmk_keymap_layer_id_t dwell_layer;
+static int64_t dwell_since;
+/* presses counted since the stats were last handed to the writeback cache */
+static bool unsaved;
+
+static uint32_t total_keystrokes(void) {
+    uint32_t total = 0;
+    for (int i = 0; i < ARRAY_SIZE(stats.presses); i++) {
+        total += stats.presses[i];
+    }
+    return total;
+}
+
+static void account_dwell(void) {
+    int64_t now = k_uptime_get();
+    stats.layer_dwell_ms[dwell_layer] += now - dwell_since;
+    dwell_since = now;
+}
+
+static int typing_stats_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *pos = as_zmk_position_state_changed(eh);
+    if (pos != NULL) {
+        if (pos->state && pos->position < ZMK_KEYMAP_LEN) {
+            /* the hot path, everything else waits for the next WPM update */
+            stats.presses[pos->position]++;
+            unsaved = true;
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_wpm_state_changed *wpm = as_zmk_wpm_state_changed(eh);
+    if (wpm != NULL) {
+        if (wpm->state > 0) {
+            stats.wpm_sum += wpm->state;
+            stats.wpm_samples++;
+            stats.peak_wpm = MAX(stats.peak_wpm, MIN(wpm->state, UINT8_MAX));
+        }
+
+        /*
+         * WPM updates keep coming while typing and until it decays to 0, which makes them the
+         * save tick. Dwell and WPM alone are not worth a flash write, they ride along with
+         * the presses.
+         */
+        if (unsaved) {
+            unsaved = false;
+            account_dwell();
+            settings_writeback_save(STATS_SETTINGS_KEY, &stats, sizeof(stats));
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    if (as_zmk_layer_state_changed(eh) != NULL) {
+        account_dwell();
+        dwell_layer = zmk_layer_cache_highest_active();
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(typing_stats, typing_stats_listener);
+ZMK_SUBSCRIPTION(typing_stats, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(typing_stats, zmk_wpm_state_changed);
+ZMK_SUBSCRIPTION(typing_stats, zmk_layer_state_changed);
+
+void typing_stats_get_summary(struct typing_stats_summary *summary) {
+    uint64_t dwell_total = 0;
+    uint64_t dwell_top = 0;
+
+    summary->top_layer = 0;
+
+    for (int i = 0; i < ARRAY_SIZE(stats.layer_dwell_ms); i++) {
+        uint64_t dwell = stats.layer_dwell_ms[i];
+        if (i == dwell_layer) {
+            dwell += k_uptime_get() - dwell_since;
+        }
+
+        dwell_total += dwell;
+        if (dwell > dwell_top) {
+            dwell_top = dwell;
+            summary->top_layer = i;
+        }
+    }
+
+    summary->keystrokes = total_keystrokes();
+    summary->peak_wpm = stats.peak_wpm;
+    summary->avg_wpm = stats.wpm_samples ? stats.wpm_sum / stats.wpm_samples : 0;
+    summary->top_layer_pct = dwell_total ? dwell_top * 100 / dwell_total : 0;
+}
+
+uint32_t typing_stats_key_presses(uint32_t position) {
+    return position < ZMK_KEYMAP_LEN ? stats.presses[position] : 0;
+}
+
+void typing_stats_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+    dwell_since = k_uptime_get();
+    settings_delete(STATS_SETTINGS_KEY);
+}
+
+void typing_stats_dump(void) {
+    struct typing_stats_summary summary;
+    typing_stats_get_summary(&summary);
+
+    LOG_INF("keys=%u peak_wpm=%u avg_wpm=%u top_layer=%u (%u%%)", summary.keystrokes,
+            summary.peak_wpm, summary.avg_wpm, summary.top_layer, summary.top_layer_pct);
+
+    for (int i = 0; i < ZMK_KEYMAP_LEN; i++) {
+        LOG_INF("position %d: %u", i, stats.presses[i]);
+    }
+}
+
+static int typing_stats_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+                                     void *cb_arg) {
+    const char *next;
+    struct typing_stats_record stored;
+
+    if (!settings_name_steq(name, "v1", &next) || next != NULL) {
+        return -ENOENT;
+    }
+
+    if (len != sizeof(stored)) {
+        LOG_WRN("Discarding typing stats with a different layout");
+        return -EINVAL;
+    }
+
+    int err = read_cb(cb_arg, &stored, sizeof(stored));
+    if (err < 0) {
+        return err;
+    }
+
+    /* keys may already have been counted before settings got loaded, merge instead of replace */
+    for (int i = 0; i < ARRAY_SIZE(stats.presses); i++) {
+        stats.presses[i] += stored.presses[i];
+    }
+    for (int i = 0; i < ARRAY_SIZE(stats.layer_dwell_ms); i++) {
+        stats.layer_dwell_ms[i] += stored.layer_dwell_ms[i];
+    }
+    stats.wpm_sum += stored.wpm_sum;
+    stats.wpm_samples += stored.wpm_samples;
+    stats.peak_wpm = MAX(stats.peak_wpm, stored.peak_wpm);
+
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(dongle_stats, "dongle_stats", NULL, typing_stats_settings_set,
+                               NULL, NULL);
+
+static int typing_stats_init(void) {
+    dwell_since = k_uptime_get();
+    return 0;
+}
+
+SYS_INIT(typing_stats_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#if IS_ENABLED(CONFIG_SHELL)
+static int cmd_typing_stats_dump(const struct shell *sh, size_t argc, char **argv) {
+    struct typing_stats_summary summary;
+    typing_stats_get_summary(&summary);
+
+    shell_print(sh, "keystrokes %u", summary.keystrokes);
+    shell_print(sh, "wpm peak %u avg %u", summary.peak_wpm, summary.avg_wpm);
+    for (int i = 0; i < ARRAY_SIZE(stats.layer_dwell_ms); i++) {
+        shell_print(sh, "layer %d %llu s", i, stats.layer_dwell_ms[i] / MSEC_PER_SEC);
+    }
+
+    /* one line per row of ten positions, easy to paste into a spreadsheet */
+    for (int row = 0; row < ZMK_KEYMAP_LEN; row += 10) {
+        char line[10 * 11 + 1];
+        int pos = 0;
+        for (int i = row; i < MIN(row + 10, ZMK_KEYMAP_LEN); i++) {
+            pos += snprintf(line + pos, sizeof(line) - pos, "%s%u", i > row ? "," : "",
+                            stats.presses[i]);
+        }
+        shell_print(sh, "%s", line);
+    }
+    return 0;
+}
+
+static int cmd_typing_stats_reset(const struct shell *sh, size_t argc, char **argv) {
+    typing_stats_reset();
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_typing_stats,
+                               SHELL_CMD(dump, NULL, "Print the typing statistics",
+                                         cmd_typing_stats_dump),
+                               SHELL_CMD(reset, NULL, "Clear the stored statistics",
+                                         cmd_typing_stats_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(typing_stats, &sub_typing_stats, "Lifetime typing statistics", NULL);
+#endif
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/keymap.h>
+#include <zmk/matrix.h>
+
+/*
+ * Lifetime typing statistics, counted in RAM and merged with what is stored in the settings
+ * partition. Readers get a best-effort snapshot: the counters are written from the event
+ * thread without locking, a key pressed during a read may or may not be included.
+ */
+struct typing_stats_summary {
+    uint32_t keystrokes;
+    uint8_t peak_wpm;
+    /* average over the WPM samples taken while typing */
+    uint8_t avg_wpm;
+    zmk_keymap_layer_id_t top_layer;
+    /* share of the tracked time spent on top_layer */
+    uint8_t top_layer_pct;
+};
+
+void typing_stats_get_summary(struct typing_stats_summary *summary);
+
+/* presses of a single key position, 0 for positions outside the keymap */
+uint32_t typing_stats_key_presses(uint32_t position);
+
+void typing_stats_reset(void);
+void typing_stats_dump(void);
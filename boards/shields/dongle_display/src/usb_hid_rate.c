@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/endpoints.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/usb.h>
+
+#include "usb_hid_rate.h"
+#include "events/usb_hid_rate_changed.h"
+
+#define RATE_WINDOW_MS 1000
+
+static struct zmk_usb_hid_rate current_rate = {
+    .interval_ms = CONFIG_USB_HID_POLL_INTERVAL_MS,
+};
+
+/* keycode events are raised on the system work queue, which also runs the window below */
+static uint32_t window_reports;
+
+static void rate_window_cb(struct k_work *work) {
+    uint16_t reports_per_sec = window_reports * 1000 / RATE_WINDOW_MS;
+
+    window_reports = 0;
+
+    if (reports_per_sec > 0) {
+        /* keep measuring until a window passes without any reports */
+        k_work_schedule(k_work_delayable_from_work(work), K_MSEC(RATE_WINDOW_MS));
+    }
+
+    if (reports_per_sec == current_rate.reports_per_sec) {
+        return;
+    }
+
+    current_rate.reports_per_sec = reports_per_sec;
+
+    raise_zmk_usb_hid_rate_changed(
+        (struct zmk_usb_hid_rate_changed){.reports_per_sec = reports_per_sec});
+}
+
+static K_WORK_DELAYABLE_DEFINE(rate_window_work, rate_window_cb);
+
+struct zmk_usb_hid_rate zmk_usb_hid_rate_get(void) { return current_rate; }
+
+/*
+ * ZMK sends its USB reports from a static function, so they can't be hooked directly. Every
+ * keycode press and release that reaches hid_listener with USB selected becomes one report,
+ * which makes this a report rate driven by typing, not the rate the host polls at.
+ */
+static int usb_hid_rate_listener(const zmk_event_t *eh) {
+    if (zmk_endpoints_selected().transport != ZMK_TRANSPORT_USB || !zmk_usb_is_hid_ready()) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    window_reports++;
+    if (!k_work_delayable_is_pending(&rate_window_work)) {
+        k_work_schedule(&rate_window_work, K_MSEC(RATE_WINDOW_MS));
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(usb_hid_rate, usb_hid_rate_listener);
+ZMK_SUBSCRIPTION(usb_hid_rate, zmk_keycode_state_changed);
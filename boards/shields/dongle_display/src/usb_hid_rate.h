@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+struct zmk_usb_hid_rate {
+    /* bInterval of the HID IN endpoint */
+    uint8_t interval_ms;
+    /* keycode reports per second during the last measurement window, 0 while not typing */
+    uint16_t reports_per_sec;
+};
+
+struct zmk_usb_hid_rate zmk_usb_hid_rate_get(void);
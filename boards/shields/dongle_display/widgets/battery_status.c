@@ -11,7 +11,6 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/display.h>
-#include <zmk/display/widgets/battery_status.h>
 #include <zmk/usb.h>
 #include <zmk/ble.h>
 #include <zmk/events/usb_conn_state_changed.h>
@@ -19,14 +18,26 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/battery_state_changed.h>
 
 #include "battery_status.h"
+#include "widget_listener.h"
 
-static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_SPLIT_RECONNECT)
+#include "../src/split_reconnect.h"
+#include "../src/events/split_central_status_changed.h"
+#endif
 
+static struct zmk_widget_peripheral_battery_status *widget_instance;
+
+/* every source travels together, a later report must not hide an earlier one */
 struct peripheral_battery_state {
-    uint8_t source;
-    uint8_t level;
+    uint8_t levels[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_SPLIT_RECONNECT)
+    /* one bit per slot */
+    uint8_t seen;
+    uint8_t connected;
+    int32_t reconnect_ms[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+#endif
 };
-    
+
 static lv_color_t battery_image_buffer[ZMK_SPLIT_BLE_PERIPHERAL_COUNT][5 * 8];
 
 static void draw_battery(lv_obj_t *canvas, uint8_t level) {
@@ -54,14 +65,14 @@ static void draw_battery(lv_obj_t *canvas, uint8_t level) {
     }
 }
 
-static void set_battery_symbol(lv_obj_t *widget, struct peripheral_battery_state state) {
-    lv_obj_t *symbol = lv_obj_get_child(widget, state.source * 2);
-    lv_obj_t *label = lv_obj_get_child(widget, state.source * 2 + 1);
+static void set_battery_symbol(lv_obj_t *widget, uint8_t source, uint8_t level) {
+    lv_obj_t *symbol = lv_obj_get_child(widget, source * 2);
+    lv_obj_t *label = lv_obj_get_child(widget, source * 2 + 1);
 
-    draw_battery(symbol, state.level);
-    lv_label_set_text_fmt(label, "%3u%%", state.level);
+    draw_battery(symbol, level);
+    lv_label_set_text_fmt(label, "%3u%%", level);
     
-    if (state.level > 0) {
+    if (level > 0) {
         lv_obj_clear_flag(symbol, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(label, LV_OBJ_FLAG_HIDDEN);
     } else {
@@ -70,23 +81,112 @@ static void set_battery_symbol(lv_obj_t *widget, struct peripheral_battery_state
     }
 }
 
+/* only touched from the display work queue */
+static struct peripheral_battery_state drawn_state;
+static bool drawn;
+
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_SPLIT_RECONNECT)
+/* slots whose label shows the reconnect time instead of the level */
+static uint8_t showing_reconnect;
+static lv_timer_t *reconnect_timer;
+
+static void reconnect_timer_cb(lv_timer_t *timer) {
+    struct zmk_widget_peripheral_battery_status *widget = widget_instance;
+
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        if ((showing_reconnect & BIT(i)) && (drawn_state.connected & BIT(i))) {
+            set_battery_symbol(widget->obj, i, drawn_state.levels[i]);
+        }
+    }
+    showing_reconnect = 0;
+    lv_timer_pause(timer);
+}
+
+/* "1.2s" for a few seconds after a half is back, "--" while it is gone */
+static void set_link_label(lv_obj_t *widget, uint8_t source,
+                           struct peripheral_battery_state state) {
+    lv_obj_t *symbol = lv_obj_get_child(widget, source * 2);
+    lv_obj_t *label = lv_obj_get_child(widget, source * 2 + 1);
+
+    if (!(state.connected & BIT(source))) {
+        showing_reconnect &= ~BIT(source);
+        lv_obj_add_flag(symbol, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(label, LV_OBJ_FLAG_HIDDEN);
+        lv_label_set_text(label, "  --");
+        return;
+    }
+
+    int32_t ms = state.reconnect_ms[source];
+    lv_obj_clear_flag(label, LV_OBJ_FLAG_HIDDEN);
+    if (ms < 10 * MSEC_PER_SEC) {
+        lv_label_set_text_fmt(label, "%d.%ds", ms / 1000, ms % 1000 / 100);
+    } else {
+        lv_label_set_text_fmt(label, "%3ds", MIN(ms / 1000, 999));
+    }
+
+    showing_reconnect |= BIT(source);
+    lv_timer_reset(reconnect_timer);
+    lv_timer_resume(reconnect_timer);
+}
+#endif
+
 void battery_status_update_cb(struct peripheral_battery_state state) {
-    struct zmk_widget_battery_status *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_battery_symbol(widget->obj, state); }
+    struct zmk_widget_peripheral_battery_status *widget = widget_instance;
+    if (widget == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_SPLIT_RECONNECT)
+        bool link_changed = !drawn || ((state.connected ^ drawn_state.connected) & BIT(i));
+        if ((state.seen & BIT(i)) && link_changed) {
+            set_link_label(widget->obj, i, state);
+            continue;
+        }
+
+        /* the level is drawn once the reconnect time has been shown */
+        if ((showing_reconnect & BIT(i)) || (state.seen & ~state.connected & BIT(i))) {
+            continue;
+        }
+#endif
+        if (!drawn || state.levels[i] != drawn_state.levels[i]) {
+            set_battery_symbol(widget->obj, i, state.levels[i]);
+        }
+    }
+
+    drawn_state = state;
+    drawn = true;
 }
 
+/* only touched from the event thread */
+static struct peripheral_battery_state reported_state;
+
 static struct peripheral_battery_state battery_status_get_state(const zmk_event_t *eh) {
     const struct zmk_peripheral_battery_state_changed *ev = as_zmk_peripheral_battery_state_changed(eh);
-    return (struct peripheral_battery_state){
-        .source = ev->source,
-        .level = ev->state_of_charge,
-    };
+    if (ev != NULL && ev->source < ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+        reported_state.levels[ev->source] = ev->state_of_charge;
+    }
+
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_SPLIT_RECONNECT)
+    const struct zmk_split_central_status_changed *status =
+        as_zmk_split_central_status_changed(eh);
+    if (status != NULL && status->slot < ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+        WRITE_BIT(reported_state.seen, status->slot, 1);
+        WRITE_BIT(reported_state.connected, status->slot, status->connected);
+        reported_state.reconnect_ms[status->slot] = split_reconnect_ms(status->slot);
+    }
+#endif
+
+    return reported_state;
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_battery_status, struct peripheral_battery_state,
-                            battery_status_update_cb, battery_status_get_state)
+DONGLE_WIDGET_LISTENER(widget_battery_status, struct peripheral_battery_state,
+                       battery_status_update_cb, battery_status_get_state)
 
 ZMK_SUBSCRIPTION(widget_battery_status, zmk_peripheral_battery_state_changed);
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_SPLIT_RECONNECT)
+ZMK_SUBSCRIPTION(widget_battery_status, zmk_split_central_status_changed);
+#endif
 
 int zmk_widget_peripheral_battery_status_init(struct zmk_widget_peripheral_battery_status *widget, lv_obj_t *parent) {
     widget->obj = lv_obj_create(parent);
@@ -103,7 +203,13 @@ int zmk_widget_peripheral_battery_status_init(struct zmk_widget_peripheral_batte
         lv_obj_align(battery_label, LV_ALIGN_TOP_RIGHT, -7, i * 10);
     }
 
-    sys_slist_append(&widgets, &widget->node);
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_SPLIT_RECONNECT)
+    reconnect_timer = lv_timer_create(reconnect_timer_cb,
+                                      CONFIG_DONGLE_DISPLAY_SPLIT_RECONNECT_SHOW_MS, NULL);
+    lv_timer_pause(reconnect_timer);
+#endif
+
+    widget_instance = widget;
 
     widget_battery_status_init();
 
@@ -4,8 +4,8 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <zephyr/devicetree.h>
 #include <zephyr/kernel.h>
-#include <zephyr/bluetooth/services/bas.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -16,10 +16,9 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/wpm.h>
 
 #include "bongo_cat.h"
+#include "widget_listener.h"
 
-#define SRC(array) (const void **)array, sizeof(array) / sizeof(lv_img_dsc_t *)
-
-static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+static struct zmk_widget_bongo_cat *widget_instance;
 
 LV_IMG_DECLARE(bongo_cat_none);
 LV_IMG_DECLARE(bongo_cat_left1);
@@ -30,7 +29,6 @@ LV_IMG_DECLARE(bongo_cat_both1);
 LV_IMG_DECLARE(bongo_cat_both1_open);
 LV_IMG_DECLARE(bongo_cat_both2);
 
-#define ANIMATION_SPEED_IDLE 10000
 const lv_img_dsc_t *idle_imgs[] = {
     &bongo_cat_both1_open,
     &bongo_cat_both1_open,
@@ -38,7 +36,6 @@ const lv_img_dsc_t *idle_imgs[] = {
     &bongo_cat_both1,
 };
 
-#define ANIMATION_SPEED_SLOW 2000
 const lv_img_dsc_t *slow_imgs[] = {
     &bongo_cat_left1,
     &bongo_cat_both1,
@@ -51,7 +48,6 @@ const lv_img_dsc_t *slow_imgs[] = {
     &bongo_cat_both1,
 };
 
-#define ANIMATION_SPEED_MID 500
 const lv_img_dsc_t *mid_imgs[] = {
     &bongo_cat_left2,
     &bongo_cat_left1,
@@ -61,7 +57,6 @@ const lv_img_dsc_t *mid_imgs[] = {
     &bongo_cat_none,
 };
 
-#define ANIMATION_SPEED_FAST 200
 const lv_img_dsc_t *fast_imgs[] = {
     &bongo_cat_both2,
     &bongo_cat_both1,
@@ -69,80 +64,157 @@ const lv_img_dsc_t *fast_imgs[] = {
     &bongo_cat_none,
 };
 
+struct bongo_cat_frames {
+    const lv_img_dsc_t **imgs;
+    uint8_t count;
+};
+
+/* in the order of the frames enum in zmk,bongo-cat-tiers.yaml */
+static const struct bongo_cat_frames frame_sets[] = {
+    {idle_imgs, ARRAY_SIZE(idle_imgs)},
+    {slow_imgs, ARRAY_SIZE(slow_imgs)},
+    {mid_imgs, ARRAY_SIZE(mid_imgs)},
+    {fast_imgs, ARRAY_SIZE(fast_imgs)},
+};
+
+#define TIERS_NODE DT_INST(0, zmk_bongo_cat_tiers)
+
+BUILD_ASSERT(DT_NODE_EXISTS(TIERS_NODE), "dongle_display.overlay defines the bongo cat tiers");
+
+struct bongo_cat_tier {
+    uint8_t min_wpm;
+    uint16_t frame_ms;
+    uint8_t frames;
+};
+
+#define BONGO_CAT_TIER(node)                                                                       \
+    {                                                                                              \
+        .min_wpm = DT_PROP(node, min_wpm),                                                         \
+        .frame_ms = DT_PROP(node, frame_ms),                                                       \
+        .frames = DT_ENUM_IDX(node, frames),                                                       \
+    }
+
+static const struct bongo_cat_tier tiers[] = {
+    DT_FOREACH_CHILD_SEP(TIERS_NODE, BONGO_CAT_TIER, (, ))};
+
+#define HYSTERESIS_WPM DT_PROP(TIERS_NODE, hysteresis_wpm)
+
 struct bongo_cat_wpm_status_state {
     uint8_t wpm;
 };
 
-enum anim_state {
-    anim_state_none,
-    anim_state_idle,
-    anim_state_slow,
-    anim_state_mid,
-    anim_state_fast
-} current_anim_state;
-
-static void set_animation(lv_obj_t *animing, struct bongo_cat_wpm_status_state state) {
-    if (state.wpm < 5) {
-        if (current_anim_state != anim_state_idle) {
-            lv_animimg_set_src(animing, SRC(idle_imgs));
-            lv_animimg_set_duration(animing, ANIMATION_SPEED_IDLE);
-            lv_animimg_set_repeat_count(animing, LV_ANIM_REPEAT_INFINITE);
-            lv_animimg_start(animing);
-            current_anim_state = anim_state_idle;
-        }
-    } else if (state.wpm < 30) {
-        if (current_anim_state != anim_state_slow) {
-            lv_animimg_set_src(animing, SRC(slow_imgs));
-            lv_animimg_set_duration(animing, ANIMATION_SPEED_SLOW);
-            lv_animimg_set_repeat_count(animing, LV_ANIM_REPEAT_INFINITE);
-            lv_animimg_start(animing);
-            current_anim_state = anim_state_slow;
-        }
-    } else if (state.wpm < 70) {
-        if (current_anim_state != anim_state_mid) {
-            lv_animimg_set_src(animing, SRC(mid_imgs));
-            lv_animimg_set_duration(animing, ANIMATION_SPEED_MID);
-            lv_animimg_set_repeat_count(animing, LV_ANIM_REPEAT_INFINITE);
-            lv_animimg_start(animing);
-            current_anim_state = anim_state_mid;
-        }
-    } else {
-        if (current_anim_state != anim_state_fast) {
-            lv_animimg_set_src(animing, SRC(fast_imgs));
-            lv_animimg_set_duration(animing, ANIMATION_SPEED_FAST);
-            lv_animimg_set_repeat_count(animing, LV_ANIM_REPEAT_INFINITE);
-            lv_animimg_start(animing);
-            current_anim_state = anim_state_fast;
-        }
+/* only touched from the display work queue */
+static struct bongo_cat_wpm_status_state last_state;
+static bool paused;
+static uint8_t current_tier;
+static uint32_t current_frame;
+static uint32_t current_frame_tick;
+static lv_timer_t *frame_timer;
+
+/* up as soon as a threshold is reached, down only once the WPM is clearly below it */
+static uint8_t select_tier(uint8_t tier, uint8_t wpm) {
+    while (tier + 1 < ARRAY_SIZE(tiers) && wpm >= tiers[tier + 1].min_wpm) {
+        tier++;
+    }
+    while (tier > 0 && wpm + HYSTERESIS_WPM < tiers[tier].min_wpm) {
+        tier--;
+    }
+    return tier;
+}
+
+/* interpolated towards the next tier, so the speed follows the WPM without steps */
+static uint32_t frame_period(uint8_t tier, uint8_t wpm) {
+    const struct bongo_cat_tier *cur = &tiers[tier];
+
+    if (tier + 1 == ARRAY_SIZE(tiers) || wpm <= cur->min_wpm) {
+        return cur->frame_ms;
+    }
+
+    const struct bongo_cat_tier *next = &tiers[tier + 1];
+    int32_t span = next->min_wpm - cur->min_wpm;
+    int32_t pos = MIN(wpm, next->min_wpm) - cur->min_wpm;
+
+    return cur->frame_ms - ((int32_t)cur->frame_ms - next->frame_ms) * pos / span;
+}
+
+static void show_frame(lv_obj_t *img) {
+    const struct bongo_cat_frames *frames = &frame_sets[tiers[current_tier].frames];
+    lv_img_set_src(img, frames->imgs[current_frame % frames->count]);
+    current_frame_tick = lv_tick_get();
+}
+
+/*
+ * LVGL runs a late timer once, not once per missed period. When the display queue fell behind
+ * the frames that were due in between are skipped so the animation keeps its pace.
+ */
+static void frame_timer_cb(lv_timer_t *timer) {
+    struct zmk_widget_bongo_cat *widget = timer->user_data;
+    uint32_t due = lv_tick_elaps(current_frame_tick) / timer->period;
+
+    current_frame += MAX(due, 1);
+    show_frame(widget->obj);
+}
+
+static void set_animation(lv_obj_t *img, struct bongo_cat_wpm_status_state state) {
+    uint8_t tier = select_tier(current_tier, state.wpm);
+
+    if (tier != current_tier) {
+        current_tier = tier;
+        current_frame = 0;
+        show_frame(img);
     }
+
+    /* the running frame keeps its start, only the next one moves */
+    lv_timer_set_period(frame_timer, frame_period(tier, state.wpm));
 }
 
 struct bongo_cat_wpm_status_state bongo_cat_wpm_status_get_state(const zmk_event_t *eh) {
-    struct zmk_wpm_state_changed *ev = as_zmk_wpm_state_changed(eh);
-    return (struct bongo_cat_wpm_status_state) { .wpm = ev->state };
+    const struct zmk_wpm_state_changed *ev = eh != NULL ? as_zmk_wpm_state_changed(eh) : NULL;
+    return (struct bongo_cat_wpm_status_state){.wpm = ev != NULL ? ev->state : zmk_wpm_get_state()};
 };
 
 void bongo_cat_wpm_status_update_cb(struct bongo_cat_wpm_status_state state) {
-    struct zmk_widget_bongo_cat *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_animation(widget->obj, state); }
+    struct zmk_widget_bongo_cat *widget = widget_instance;
+    last_state = state;
+    if (widget != NULL && !paused) { set_animation(widget->obj, state); }
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_bongo_cat, struct bongo_cat_wpm_status_state,
-                            bongo_cat_wpm_status_update_cb, bongo_cat_wpm_status_get_state)
+DONGLE_WIDGET_LISTENER(widget_bongo_cat, struct bongo_cat_wpm_status_state,
+                       bongo_cat_wpm_status_update_cb, bongo_cat_wpm_status_get_state)
 
 ZMK_SUBSCRIPTION(widget_bongo_cat, zmk_wpm_state_changed);
 
 int zmk_widget_bongo_cat_init(struct zmk_widget_bongo_cat *widget, lv_obj_t *parent) {
-    widget->obj = lv_animimg_create(parent);
+    widget->obj = lv_img_create(parent);
     lv_obj_center(widget->obj);
 
-    sys_slist_append(&widgets, &widget->node);
+    frame_timer = lv_timer_create(frame_timer_cb, tiers[0].frame_ms, widget);
+    show_frame(widget->obj);
+
+    widget_instance = widget;
 
     widget_bongo_cat_init();
 
     return 0;
 }
 
+void zmk_widget_bongo_cat_set_paused(struct zmk_widget_bongo_cat *widget, bool pause) {
+    if (pause == paused) {
+        return;
+    }
+
+    paused = pause;
+
+    if (pause) {
+        /* the current frame stays on screen */
+        lv_timer_pause(frame_timer);
+    } else {
+        set_animation(widget->obj, last_state);
+        lv_timer_reset(frame_timer);
+        lv_timer_resume(frame_timer);
+    }
+}
+
 lv_obj_t *zmk_widget_bongo_cat_obj(struct zmk_widget_bongo_cat *widget) {
     return widget->obj;
-}
\ No newline at end of file
+}
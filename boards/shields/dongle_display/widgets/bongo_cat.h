@@ -11,9 +11,9 @@
 #include <dt-bindings/zmk/modifiers.h>
 
 struct zmk_widget_bongo_cat {
-    sys_snode_t node;
     lv_obj_t *obj;
 };
 
 int zmk_widget_bongo_cat_init(struct zmk_widget_bongo_cat *widget, lv_obj_t *parent);
+void zmk_widget_bongo_cat_set_paused(struct zmk_widget_bongo_cat *widget, bool pause);
 lv_obj_t *zmk_widget_bongo_cat_obj(struct zmk_widget_bongo_cat *widget);
\ No newline at end of file
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/matrix.h>
+#include <zmk/physical_layouts.h>
+
+#include "../src/typing_stats.h"
+#include "heatmap_page.h"
+#include "widget_listener.h"
+
+#define HEATMAP_WIDTH DT_PROP(DT_CHOSEN(zephyr_display), width)
+#define HEATMAP_HEIGHT DT_PROP(DT_CHOSEN(zephyr_display), height)
+#define HEATMAP_STRIDE ((HEATMAP_WIDTH + 7) / 8)
+/* indexed canvases keep their palette in front of the pixels */
+#define HEATMAP_PALETTE_SIZE (sizeof(lv_color32_t) * 2)
+
+#define HEATMAP_LEVELS 16
+
+/*
+ * 4x4 ordered dither, one byte per pattern row with the 4 pixel period repeated twice, so a
+ * row of a cell is filled a byte at a time. A pixel is set when its threshold is below the
+ * level, which keeps every level a superset of the one below it.
+ */
+static const uint8_t bayer_rows[HEATMAP_LEVELS + 1][4] = {
+    {0x00, 0x00, 0x00, 0x00}, {0x88, 0x00, 0x00, 0x00}, {0x88, 0x00, 0x22, 0x00},
+    {0xaa, 0x00, 0x22, 0x00}, {0xaa, 0x00, 0xaa, 0x00}, {0xaa, 0x44, 0xaa, 0x00},
+    {0xaa, 0x44, 0xaa, 0x11}, {0xaa, 0x55, 0xaa, 0x11}, {0xaa, 0x55, 0xaa, 0x55},
+    {0xee, 0x55, 0xaa, 0x55}, {0xee, 0x55, 0xbb, 0x55}, {0xff, 0x55, 0xbb, 0x55},
+    {0xff, 0x55, 0xff, 0x55}, {0xff, 0xdd, 0xff, 0x55}, {0xff, 0xdd, 0xff, 0x77},
+    {0xff, 0xff, 0xff, 0x77}, {0xff, 0xff, 0xff, 0xff},
+};
+
+/* outline of the key in canvas pixels, the dither fills the inside */
+struct heatmap_cell {
+    lv_area_t area;
+    uint8_t level;
+};
+
+static struct zmk_widget_heatmap_page *widget_instance;
+
+static uint8_t canvas_buf[HEATMAP_PALETTE_SIZE + HEATMAP_STRIDE * HEATMAP_HEIGHT];
+static struct heatmap_cell cells[ZMK_KEYMAP_LEN];
+static uint8_t cells_len;
+
+static inline uint8_t *heatmap_pixels(void) { return canvas_buf + HEATMAP_PALETTE_SIZE; }
+
+static void fill_row(uint8_t *row, lv_coord_t x1, lv_coord_t x2, uint8_t pattern) {
+    for (lv_coord_t x = x1; x <= x2;) {
+        uint8_t bit = x & 7;
+        uint8_t span = MIN(8 - bit, x2 - x + 1);
+        uint8_t mask = (uint8_t)(0xff << (8 - span)) >> bit;
+
+        row[x >> 3] = (row[x >> 3] & ~mask) | (pattern & mask);
+        x += span;
+    }
+}
+
+static void draw_cell_outline(const struct heatmap_cell *cell) {
+    const lv_area_t *a = &cell->area;
+    uint8_t *pixels = heatmap_pixels();
+
+    fill_row(pixels + a->y1 * HEATMAP_STRIDE, a->x1, a->x2, 0xff);
+    fill_row(pixels + a->y2 * HEATMAP_STRIDE, a->x1, a->x2, 0xff);
+    for (lv_coord_t y = a->y1 + 1; y < a->y2; y++) {
+        fill_row(pixels + y * HEATMAP_STRIDE, a->x1, a->x1, 0xff);
+        fill_row(pixels + y * HEATMAP_STRIDE, a->x2, a->x2, 0xff);
+    }
+}
+
+static void draw_cell_level(lv_obj_t *canvas, const struct heatmap_cell *cell) {
+    const lv_area_t *a = &cell->area;
+    uint8_t *pixels = heatmap_pixels();
+
+    for (lv_coord_t y = a->y1 + 1; y < a->y2; y++) {
+        fill_row(pixels + y * HEATMAP_STRIDE, a->x1 + 1, a->x2 - 1,
+                 bayer_rows[cell->level][y & 3]);
+    }
+
+    lv_area_t area = *a;
+    lv_area_move(&area, canvas->coords.x1, canvas->coords.y1);
+    lv_obj_invalidate_area(canvas, &area);
+}
+
+/* Scale the physical layout onto the canvas, leaving a pixel between neighbouring keys */
+static void build_cells(void) {
+    const struct zmk_physical_layout *const *layouts;
+    int count = zmk_physical_layouts_get_list(&layouts);
+    int selected = zmk_physical_layouts_get_selected();
+
+    if (count <= 0 || selected < 0) {
+        LOG_WRN("No physical layout, heatmap page stays empty");
+        return;
+    }
+
+    const struct zmk_physical_layout *layout = layouts[selected];
+    int32_t max_x = 1, max_y = 1;
+
+    cells_len = MIN(layout->keys_len, ARRAY_SIZE(cells));
+
+    for (int i = 0; i < cells_len; i++) {
+        max_x = MAX(max_x, layout->keys[i].x + layout->keys[i].width);
+        max_y = MAX(max_y, layout->keys[i].y + layout->keys[i].height);
+    }
+
+    for (int i = 0; i < cells_len; i++) {
+        const struct zmk_key_physical_attrs *key = &layout->keys[i];
+        cells[i].area = (lv_area_t){
+            .x1 = key->x * (HEATMAP_WIDTH - 1) / max_x,
+            .y1 = key->y * (HEATMAP_HEIGHT - 1) / max_y,
+            .x2 = (key->x + key->width) * (HEATMAP_WIDTH - 1) / max_x - 1,
+            .y2 = (key->y + key->height) * (HEATMAP_HEIGHT - 1) / max_y - 1,
+        };
+        cells[i].level = 0;
+        draw_cell_outline(&cells[i]);
+    }
+}
+
+struct heatmap_page_state {
+    bool pressed;
+};
+
+/* Quantize against the busiest key and only touch the cells whose level moved */
+static void heatmap_page_update_cb(struct heatmap_page_state state) {
+    struct zmk_widget_heatmap_page *widget = widget_instance;
+    uint32_t max = 1;
+
+    if (widget == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < cells_len; i++) {
+        max = MAX(max, typing_stats_key_presses(i));
+    }
+
+    for (int i = 0; i < cells_len; i++) {
+        uint8_t level =
+            (uint8_t)(((uint64_t)typing_stats_key_presses(i) * HEATMAP_LEVELS + max / 2) / max);
+
+        if (level != cells[i].level) {
+            cells[i].level = level;
+            draw_cell_level(widget->obj, &cells[i]);
+        }
+    }
+}
+
+static struct heatmap_page_state heatmap_page_get_state(const zmk_event_t *eh) {
+    return (struct heatmap_page_state){.pressed = true};
+}
+
+/*
+ * The counters themselves are read on the display queue, so a burst of key presses costs a
+ * single pass over the cells however many events were coalesced into it.
+ */
+DONGLE_WIDGET_LISTENER(widget_heatmap_page, struct heatmap_page_state, heatmap_page_update_cb,
+                       heatmap_page_get_state)
+
+ZMK_SUBSCRIPTION(widget_heatmap_page, zmk_position_state_changed);
+
+int zmk_widget_heatmap_page_init(struct zmk_widget_heatmap_page *widget, lv_obj_t *parent) {
+    widget->obj = lv_canvas_create(parent);
+    lv_canvas_set_buffer(widget->obj, canvas_buf, HEATMAP_WIDTH, HEATMAP_HEIGHT,
+                         LV_IMG_CF_INDEXED_1BIT);
+    lv_canvas_set_palette(widget->obj, 0, lv_color_white());
+    lv_canvas_set_palette(widget->obj, 1, lv_color_black());
+
+    memset(heatmap_pixels(), 0, HEATMAP_STRIDE * HEATMAP_HEIGHT);
+    build_cells();
+
+    widget_instance = widget;
+
+    widget_heatmap_page_init();
+    return 0;
+}
+
+lv_obj_t *zmk_widget_heatmap_page_obj(struct zmk_widget_heatmap_page *widget) {
+    return widget->obj;
+}
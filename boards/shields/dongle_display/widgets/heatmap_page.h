@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+struct zmk_widget_heatmap_page {
+    lv_obj_t *obj;
+};
+
+int zmk_widget_heatmap_page_init(struct zmk_widget_heatmap_page *widget, lv_obj_t *parent);
+lv_obj_t *zmk_widget_heatmap_page_obj(struct zmk_widget_heatmap_page *widget);
@@ -15,17 +15,33 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/hid_indicators_changed.h>
 #include "../src/events/caps_word_state_changed.h"
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_TIMELINE_MACRO)
+#include <zmk/events/timeline_macro_state_changed.h>
+#endif
+
+#include "../src/glyph_blit.h"
+#include "glyph_subsets.h"
 #include "hid_indicators.h"
+#include "widget_listener.h"
 
 #define LED_NLCK 0x01
 #define LED_CLCK 0x02
 #define LED_SLCK 0x04
 
-static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+#define INDICATORS_WIDTH 44
+
+static struct zmk_widget_hid_indicators *widget_instance;
 
-static void set_hid_indicators(lv_obj_t *label, struct hid_indicators_state state) {
+static struct glyph_label indicators_label;
+static uint8_t indicators_label_buf[GLYPH_LABEL_BUF_SIZE(INDICATORS_WIDTH,
+                                                         GLYPH_SUBSET_INDICATOR_LINE_HEIGHT)];
+
+static void set_hid_indicators(struct glyph_label *label, struct hid_indicators_state state) {
     char text[7] = {};
 
+    if (state.macros_active) {
+        strncat(text, "M", 1);
+    }
     if (state.caps_word_active) {
         strncat(text, "W", 1);
     }
@@ -39,14 +55,14 @@ static void set_hid_indicators(lv_obj_t *label, struct hid_indicators_state stat
         strncat(text, "S", 1);
     }
 
-    lv_label_set_text(label, text);
+    glyph_label_set_text(label, text);
 }
 
 void hid_indicators_update_cb(struct hid_indicators_state state) {
-    struct zmk_widget_hid_indicators *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+    struct zmk_widget_hid_indicators *widget = widget_instance;
+    if (widget != NULL) {
         widget->state.hid_indicators = state.hid_indicators;
-        set_hid_indicators(widget->obj, widget->state); 
+        set_hid_indicators(&indicators_label, widget->state); 
     }
 }
 
@@ -57,16 +73,16 @@ static struct hid_indicators_state hid_indicators_get_state(const zmk_event_t *e
     };
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_hid_indicators, struct hid_indicators_state,
-                            hid_indicators_update_cb, hid_indicators_get_state)
+DONGLE_WIDGET_LISTENER(widget_hid_indicators, struct hid_indicators_state,
+                       hid_indicators_update_cb, hid_indicators_get_state)
 
 ZMK_SUBSCRIPTION(widget_hid_indicators, zmk_hid_indicators_changed);
 
 static void caps_word_indicator_update_cb(struct hid_indicators_state state) {
-    struct zmk_widget_hid_indicators *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+    struct zmk_widget_hid_indicators *widget = widget_instance;
+    if (widget != NULL) {
         widget->state.caps_word_active = state.caps_word_active;
-        set_hid_indicators(widget->obj, widget->state);
+        set_hid_indicators(&indicators_label, widget->state);
     }
 }
 
@@ -78,23 +94,53 @@ static struct hid_indicators_state caps_word_indicator_get_state(const zmk_event
     };
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_caps_word_indicator, struct hid_indicators_state,
-                            caps_word_indicator_update_cb, caps_word_indicator_get_state)
+DONGLE_WIDGET_LISTENER(widget_caps_word_indicator, struct hid_indicators_state,
+                       caps_word_indicator_update_cb, caps_word_indicator_get_state)
 ZMK_SUBSCRIPTION(widget_caps_word_indicator, zmk_caps_word_state_changed);
 
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_TIMELINE_MACRO)
+static uint32_t macros_active;
+
+static void timeline_macro_indicator_update_cb(struct hid_indicators_state state) {
+    struct zmk_widget_hid_indicators *widget = widget_instance;
+    if (widget != NULL) {
+        widget->state.macros_active = state.macros_active;
+        set_hid_indicators(&indicators_label, widget->state);
+    }
+}
+
+static struct hid_indicators_state timeline_macro_indicator_get_state(const zmk_event_t *eh) {
+    const struct zmk_timeline_macro_state_changed *ev =
+        as_zmk_timeline_macro_state_changed(eh);
+
+    /* accumulate here, the display work item only ever sees the latest state */
+    if (ev != NULL) {
+        WRITE_BIT(macros_active, ev->index, ev->active);
+    }
+
+    return (struct hid_indicators_state){
+        .macros_active = macros_active,
+    };
+}
+
+DONGLE_WIDGET_LISTENER(widget_timeline_macro_indicator, struct hid_indicators_state,
+                       timeline_macro_indicator_update_cb, timeline_macro_indicator_get_state)
+ZMK_SUBSCRIPTION(widget_timeline_macro_indicator, zmk_timeline_macro_state_changed);
+#endif
+
 int zmk_widget_hid_indicators_init(struct zmk_widget_hid_indicators *widget, lv_obj_t *parent) {
-    widget->obj = lv_label_create(parent);
+    glyph_label_init(&indicators_label, parent, &glyph_subset_indicator, indicators_label_buf,
+                     INDICATORS_WIDTH, LV_TEXT_ALIGN_RIGHT);
+    widget->obj = indicators_label.obj;
     widget->state = (struct hid_indicators_state){0};
-    
-    lv_obj_set_width(widget->obj, 44);
-    lv_label_set_long_mode(widget->obj, LV_LABEL_LONG_CLIP);
-    lv_obj_set_style_text_align(widget->obj, LV_TEXT_ALIGN_RIGHT, 0);
-    lv_obj_set_style_text_font(widget->obj, &lv_font_montserrat_12, 0);
 
-    sys_slist_append(&widgets, &widget->node);
+    widget_instance = widget;
 
     widget_hid_indicators_init();
     widget_caps_word_indicator_init();
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_TIMELINE_MACRO)
+    widget_timeline_macro_indicator_init();
+#endif
 
     return 0;
 }
@@ -12,9 +12,9 @@
 struct hid_indicators_state {    
     uint8_t hid_indicators;
     bool caps_word_active;
+    uint32_t macros_active;
 };
 struct zmk_widget_hid_indicators {
-    sys_snode_t node;
     lv_obj_t *obj;
     struct hid_indicators_state state;
 };
@@ -9,58 +9,75 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/display.h>
-#include <zmk/display/widgets/layer_status.h>
 #include <zmk/events/layer_state_changed.h>
 #include <zmk/event_manager.h>
 #include <zmk/endpoints.h>
 #include <zmk/keymap.h>
 
-static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+#include "../src/glyph_blit.h"
+#include "../src/layer_cache.h"
+#include "glyph_subsets.h"
+#include "layer_status.h"
+#include "widget_listener.h"
+
+static struct zmk_widget_layer_status *widget_instance;
+
+static struct glyph_label layer_label;
+static uint8_t layer_label_buf[GLYPH_LABEL_BUF_SIZE(GLYPH_SUBSET_LAYER_MAX_WIDTH,
+                                                    GLYPH_SUBSET_LAYER_LINE_HEIGHT)];
 
 struct layer_status_state {
     uint8_t index;
     const char *label;
 };
 
-static void set_layer_symbol(lv_obj_t *label, struct layer_status_state state) {
+static void set_layer_symbol(struct glyph_label *label, struct layer_status_state state) {
     if (state.label == NULL) {
         char text[7] = {};
 
         sprintf(text, "%i", state.index);
 
-        lv_label_set_text(label, text);
+        glyph_label_set_text(label, text);
     } else {
         char text[13] = {};
 
         snprintf(text, sizeof(text), "%s", state.label);
 
-        lv_label_set_text(label, text);
+        glyph_label_set_text(label, text);
     }
 }
 
+static struct layer_status_state last_state = {.index = UINT8_MAX};
+
 static void layer_status_update_cb(struct layer_status_state state) {
-    struct zmk_widget_layer_status *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_layer_symbol(widget->obj, state); }
+    /* conditional layers cascade into several events for the same effective layer */
+    if (state.index == last_state.index && state.label == last_state.label) {
+        return;
+    }
+    last_state = state;
+
+    struct zmk_widget_layer_status *widget = widget_instance;
+    if (widget != NULL) { set_layer_symbol(&layer_label, state); }
 }
 
 static struct layer_status_state layer_status_get_state(const zmk_event_t *eh) {
-    uint8_t index = zmk_keymap_highest_layer_active();
     return (struct layer_status_state) {
-        .index = index,
-        .label = zmk_keymap_layer_name(index)
+        .index = zmk_layer_cache_highest_active(),
+        .label = zmk_layer_cache_highest_name()
     };
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_layer_status, struct layer_status_state, layer_status_update_cb,
-                            layer_status_get_state)
+DONGLE_WIDGET_LISTENER(widget_layer_status, struct layer_status_state, layer_status_update_cb,
+                       layer_status_get_state)
 
 ZMK_SUBSCRIPTION(widget_layer_status, zmk_layer_state_changed);
 
 int zmk_widget_layer_status_init(struct zmk_widget_layer_status *widget, lv_obj_t *parent) {
-    widget->obj = lv_label_create(parent);
+    glyph_label_init(&layer_label, parent, &glyph_subset_layer, layer_label_buf,
+                     GLYPH_SUBSET_LAYER_MAX_WIDTH, LV_TEXT_ALIGN_LEFT);
+    widget->obj = layer_label.obj;
 
-    lv_obj_set_style_text_font(widget->obj, &lv_font_montserrat_16, 0);
-    sys_slist_append(&widgets, &widget->node);
+    widget_instance = widget;
 
     widget_layer_status_init();
     return 0;
@@ -10,7 +10,6 @@
 #include <zephyr/kernel.h>
 
 struct zmk_widget_layer_status {
-    sys_snode_t node;
     lv_obj_t *obj;
 };
 
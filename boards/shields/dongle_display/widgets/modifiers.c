@@ -17,6 +17,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <dt-bindings/zmk/modifiers.h>
 
 #include "modifiers.h"
+#include "widget_listener.h"
 
 struct modifiers_state {
     uint8_t modifiers;
@@ -76,7 +77,7 @@ struct modifier_symbol *modifier_symbols[] = {
 
 #define NUM_SYMBOLS (sizeof(modifier_symbols) / sizeof(struct modifier_symbol *))
 
-static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+static struct zmk_widget_modifiers *widget_instance;
 
 /* ---------- Opacity animations + helpers ---------- */
 static void anim_opa_cb(void *var, int32_t v) {
@@ -219,8 +220,8 @@ static void set_modifiers(lv_obj_t *widget, struct modifiers_state state) {
 }
 
 void modifiers_update_cb(struct modifiers_state state) {
-    struct zmk_widget_modifiers *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_modifiers(widget->obj, state); }
+    struct zmk_widget_modifiers *widget = widget_instance;
+    if (widget != NULL) { set_modifiers(widget->obj, state); }
 }
 
 static struct modifiers_state modifiers_get_state(const zmk_event_t *eh) {
@@ -229,8 +230,8 @@ static struct modifiers_state modifiers_get_state(const zmk_event_t *eh) {
     };
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_modifiers, struct modifiers_state,
-                            modifiers_update_cb, modifiers_get_state)
+DONGLE_WIDGET_LISTENER(widget_modifiers, struct modifiers_state,
+                       modifiers_update_cb, modifiers_get_state)
 
 ZMK_SUBSCRIPTION(widget_modifiers, zmk_keycode_state_changed);
 
@@ -268,7 +269,7 @@ int zmk_widget_modifiers_init(struct zmk_widget_modifiers *widget, lv_obj_t *par
         lv_obj_set_y(modifier_symbols[i]->selection_line, SIZE_SYMBOLS + 4);
     }
 
-    sys_slist_append(&widgets, &widget->node);
+    widget_instance = widget;
     widget_modifiers_init();
     return 0;
 }
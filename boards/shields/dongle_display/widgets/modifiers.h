@@ -13,7 +13,6 @@
 #define SIZE_SYMBOLS 14 // 14 x 14 pixel
 
 struct zmk_widget_modifiers {
-    sys_snode_t node;
     lv_obj_t *obj;
 };
 
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <stdio.h>
+
 #include <zephyr/kernel.h>
 
 #include <zephyr/logging/log.h>
@@ -19,8 +21,24 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/endpoints.h>
 
 #include "output_status.h"
+#include "widget_listener.h"
+
+#if IS_ENABLED(CONFIG_ZMK_USB)
+#include "../src/usb_hid_rate.h"
+#include "../src/events/usb_hid_rate_changed.h"
+#endif
+
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_BLE_SWITCH_TIMER)
+#include "../src/ble_switch_timer.h"
+#include "../src/events/ble_switch_timed.h"
+#endif
 
-static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_HOST_LINKS)
+#include "../src/host_links.h"
+#include "../src/events/host_links_changed.h"
+#endif
+
+static struct zmk_widget_output_status *widget_instance;
 
 LV_IMG_DECLARE(sym_usb);
 LV_IMG_DECLARE(sym_bt);
@@ -47,7 +65,10 @@ enum output_symbol {
     output_symbol_bt,
     output_symbol_bt_number,
     output_symbol_bt_status,
-    output_symbol_selection_line
+    output_symbol_selection_line,
+    output_symbol_usb_rate,
+    output_symbol_bt_switch_time,
+    output_symbol_bt_hosts
 };
 
 /* selection line kept but always hidden now */
@@ -59,6 +80,15 @@ struct output_status_state {
     bool active_profile_connected;
     bool active_profile_bonded;
     bool usb_is_hid_ready;
+#if IS_ENABLED(CONFIG_ZMK_USB)
+    struct zmk_usb_hid_rate usb_hid_rate;
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_BLE_SWITCH_TIMER)
+    struct zmk_ble_switch_time switch_time;
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_HOST_LINKS)
+    struct zmk_host_links host_links;
+#endif
 };
 
 static struct output_status_state get_state(const zmk_event_t *_eh) {
@@ -67,10 +97,37 @@ static struct output_status_state get_state(const zmk_event_t *_eh) {
         .active_profile_index = zmk_ble_active_profile_index(),
         .active_profile_connected = zmk_ble_active_profile_is_connected(),
         .active_profile_bonded = !zmk_ble_active_profile_is_open(),
-        .usb_is_hid_ready = zmk_usb_is_hid_ready()
+        .usb_is_hid_ready = zmk_usb_is_hid_ready(),
+#if IS_ENABLED(CONFIG_ZMK_USB)
+        .usb_hid_rate = zmk_usb_hid_rate_get(),
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_BLE_SWITCH_TIMER)
+        .switch_time = zmk_ble_switch_time_get(),
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_HOST_LINKS)
+        .host_links = zmk_host_links_get(),
+#endif
     };
 }
 
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_HOST_LINKS)
+/* "1 3!" lists every connected host by profile number, '!' marks a weak link */
+static void set_hosts_text(lv_obj_t *label, struct zmk_host_links links) {
+    char text[ZMK_BLE_PROFILE_COUNT * 3 + 1];
+    int pos = 0;
+
+    for (int i = 0; i < ZMK_BLE_PROFILE_COUNT; i++) {
+        if (links.connected & BIT(i)) {
+            pos += snprintf(text + pos, sizeof(text) - pos, "%s%d%s", pos ? " " : "", i + 1,
+                            (links.weak & BIT(i)) ? "!" : "");
+        }
+    }
+    text[pos] = '\0';
+
+    lv_label_set_text(label, text);
+}
+#endif
+
 static void set_status_symbol(lv_obj_t *widget, struct output_status_state state) {
     lv_obj_t *usb = lv_obj_get_child(widget, output_symbol_usb);
     lv_obj_t *usb_hid_status = lv_obj_get_child(widget, output_symbol_usb_hid_status);
@@ -78,6 +135,9 @@ static void set_status_symbol(lv_obj_t *widget, struct output_status_state state
     lv_obj_t *bt_number = lv_obj_get_child(widget, output_symbol_bt_number);
     lv_obj_t *bt_status = lv_obj_get_child(widget, output_symbol_bt_status);
     lv_obj_t *selection_line = lv_obj_get_child(widget, output_symbol_selection_line);
+    lv_obj_t *usb_rate = lv_obj_get_child(widget, output_symbol_usb_rate);
+    lv_obj_t *bt_switch_time = lv_obj_get_child(widget, output_symbol_bt_switch_time);
+    lv_obj_t *bt_hosts = lv_obj_get_child(widget, output_symbol_bt_hosts);
 
     /* Always hide the selection line (we only show one output now) */
     if (selection_line) {
@@ -92,14 +152,27 @@ static void set_status_symbol(lv_obj_t *widget, struct output_status_state state
         lv_obj_add_flag(bt, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(bt_number, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(bt_status, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(bt_switch_time, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(bt_hosts, LV_OBJ_FLAG_HIDDEN);
 
         /* Update USB HID status icon */
         lv_img_set_src(usb_hid_status, state.usb_is_hid_ready ? &sym_ok : &sym_nok);
 
+#if IS_ENABLED(CONFIG_ZMK_USB)
+        /* Report rate while typing, configured poll interval otherwise */
+        lv_obj_clear_flag(usb_rate, LV_OBJ_FLAG_HIDDEN);
+        if (state.usb_hid_rate.reports_per_sec > 0) {
+            lv_label_set_text_fmt(usb_rate, "%ur/s", state.usb_hid_rate.reports_per_sec);
+        } else {
+            lv_label_set_text_fmt(usb_rate, "%ums", state.usb_hid_rate.interval_ms);
+        }
+#endif
+
     } else { /* ZMK_TRANSPORT_BLE */
         /* Show BT; hide USB */
         lv_obj_add_flag(usb, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(usb_hid_status, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(usb_rate, LV_OBJ_FLAG_HIDDEN);
 
         lv_obj_clear_flag(bt, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(bt_number, LV_OBJ_FLAG_HIDDEN);
@@ -119,19 +192,43 @@ static void set_status_symbol(lv_obj_t *widget, struct output_status_state state
         } else {
             lv_img_set_src(bt_status, &sym_open);
         }
+
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_BLE_SWITCH_TIMER)
+        /* How long the last switch to this profile took until the first key got through */
+        if (state.switch_time.profile == state.active_profile_index) {
+            lv_obj_clear_flag(bt_switch_time, LV_OBJ_FLAG_HIDDEN);
+            lv_label_set_text_fmt(bt_switch_time, "%ums", state.switch_time.first_key_ms);
+        } else {
+            lv_obj_add_flag(bt_switch_time, LV_OBJ_FLAG_HIDDEN);
+        }
+#endif
+
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_HOST_LINKS)
+        lv_obj_clear_flag(bt_hosts, LV_OBJ_FLAG_HIDDEN);
+        set_hosts_text(bt_hosts, state.host_links);
+#endif
     }
 }
 
 static void output_status_update_cb(struct output_status_state state) {
-    struct zmk_widget_output_status *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_status_symbol(widget->obj, state); }
+    struct zmk_widget_output_status *widget = widget_instance;
+    if (widget != NULL) { set_status_symbol(widget->obj, state); }
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_output_status, struct output_status_state,
-                            output_status_update_cb, get_state)
+DONGLE_WIDGET_LISTENER(widget_output_status, struct output_status_state,
+                       output_status_update_cb, get_state)
 ZMK_SUBSCRIPTION(widget_output_status, zmk_endpoint_changed);
 ZMK_SUBSCRIPTION(widget_output_status, zmk_ble_active_profile_changed);
 ZMK_SUBSCRIPTION(widget_output_status, zmk_usb_conn_state_changed);
+#if IS_ENABLED(CONFIG_ZMK_USB)
+ZMK_SUBSCRIPTION(widget_output_status, zmk_usb_hid_rate_changed);
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_BLE_SWITCH_TIMER)
+ZMK_SUBSCRIPTION(widget_output_status, zmk_ble_switch_timed);
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_HOST_LINKS)
+ZMK_SUBSCRIPTION(widget_output_status, zmk_host_links_changed);
+#endif
 
 int zmk_widget_output_status_init(struct zmk_widget_output_status *widget, lv_obj_t *parent) {
     widget->obj = lv_obj_create(parent);
@@ -168,7 +265,22 @@ int zmk_widget_output_status_init(struct zmk_widget_output_status *widget, lv_ob
     lv_obj_align_to(selection_line, usb, LV_ALIGN_OUT_TOP_LEFT, 3, -1);
     lv_obj_add_flag(selection_line, LV_OBJ_FLAG_HIDDEN);
 
-    sys_slist_append(&widgets, &widget->node);
+    /* USB poll interval / report rate */
+    lv_obj_t *usb_rate = lv_label_create(widget->obj);
+    lv_obj_align_to(usb_rate, usb, LV_ALIGN_OUT_RIGHT_TOP, 12, 0);
+    lv_obj_add_flag(usb_rate, LV_OBJ_FLAG_HIDDEN);
+
+    /* BLE profile switch time */
+    lv_obj_t *bt_switch_time = lv_label_create(widget->obj);
+    lv_obj_align_to(bt_switch_time, bt, LV_ALIGN_OUT_RIGHT_TOP, 10, 0);
+    lv_obj_add_flag(bt_switch_time, LV_OBJ_FLAG_HIDDEN);
+
+    /* Connected hosts and their link health */
+    lv_obj_t *bt_hosts = lv_label_create(widget->obj);
+    lv_obj_align_to(bt_hosts, bt, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 1);
+    lv_obj_add_flag(bt_hosts, LV_OBJ_FLAG_HIDDEN);
+
+    widget_instance = widget;
 
     widget_output_status_init();
     return 0;
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/battery_state_changed.h>
+#include <zmk/events/layer_state_changed.h>
+#include <zmk/events/wpm_state_changed.h>
+#include <zmk/ble.h>
+#include <zmk/keymap.h>
+
+#include "../src/battery_predictor.h"
+#include "../src/boot_timing.h"
+#include "../src/typing_stats.h"
+#include "stats_page.h"
+#include "widget_listener.h"
+
+static struct zmk_widget_stats_page *widget_instance;
+
+struct stats_page_state {
+    struct typing_stats_summary summary;
+    int32_t battery_minutes[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+    /* uptime at which the host could first receive reports, independent of when typing began */
+    int32_t host_ready_ms;
+};
+
+/* "12d", "9h" or "45m", the estimate is not worth more precision */
+static int format_time_left(char *buf, size_t len, int32_t minutes) {
+    if (minutes < 0) {
+        return snprintf(buf, len, " --");
+    }
+    if (minutes >= 48 * 60) {
+        return snprintf(buf, len, " %dd", minutes / (24 * 60));
+    }
+    if (minutes >= 60) {
+        return snprintf(buf, len, " %dh", minutes / 60);
+    }
+    return snprintf(buf, len, " %dm", minutes);
+}
+
+static void set_stats_text(lv_obj_t *label, struct stats_page_state state) {
+    const char *layer = zmk_keymap_layer_name(state.summary.top_layer);
+    char text[112] = {};
+
+    int pos = snprintf(text, sizeof(text), "Keys %u\nWPM  %u pk %u avg\nLyr  %.8s %u%%\nBat ",
+                       state.summary.keystrokes, state.summary.peak_wpm, state.summary.avg_wpm,
+                       layer != NULL ? layer : "?", state.summary.top_layer_pct);
+
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT && pos < sizeof(text); i++) {
+        pos += format_time_left(text + pos, sizeof(text) - pos, state.battery_minutes[i]);
+    }
+
+#if IS_ENABLED(CONFIG_DONGLE_DISPLAY_BOOT_TIMING)
+    if (pos < sizeof(text) && state.host_ready_ms >= 0) {
+        snprintf(text + pos, sizeof(text) - pos, "\nHID  %dms", state.host_ready_ms);
+    }
+#endif
+
+    lv_label_set_text(label, text);
+}
+
+static void stats_page_update_cb(struct stats_page_state state) {
+    struct zmk_widget_stats_page *widget = widget_instance;
+    if (widget != NULL) { set_stats_text(widget->obj, state); }
+}
+
+/* WPM updates arrive about once a second while typing, which is plenty for lifetime totals */
+static struct stats_page_state stats_page_get_state(const zmk_event_t *eh) {
+    struct stats_page_state state;
+    typing_stats_get_summary(&state.summary);
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        state.battery_minutes[i] = battery_predictor_minutes_left(i);
+    }
+    state.host_ready_ms = boot_timing_ms(boot_stage_host_ready);
+    return state;
+}
+
+DONGLE_WIDGET_LISTENER(widget_stats_page, struct stats_page_state, stats_page_update_cb,
+                       stats_page_get_state)
+
+ZMK_SUBSCRIPTION(widget_stats_page, zmk_wpm_state_changed);
+ZMK_SUBSCRIPTION(widget_stats_page, zmk_layer_state_changed);
+ZMK_SUBSCRIPTION(widget_stats_page, zmk_peripheral_battery_state_changed);
+
+int zmk_widget_stats_page_init(struct zmk_widget_stats_page *widget, lv_obj_t *parent) {
+    widget->obj = lv_label_create(parent);
+
+    widget_instance = widget;
+
+    widget_stats_page_init();
+    return 0;
+}
+
+lv_obj_t *zmk_widget_stats_page_obj(struct zmk_widget_stats_page *widget) {
+    return widget->obj;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+
+#include "../src/display_render.h"
+#include "../src/listener_profiler.h"
+#include "../src/state_mailbox.h"
+
+/*
+ * Same contract as ZMK_DISPLAY_WIDGET_LISTENER: state_func captures the widget state on the
+ * event thread, cb applies it on the display work queue. The state is handed over through a
+ * latest-value-wins mailbox that producers on any thread can put to, so capture never waits on
+ * rendering and states that are overwritten before the display queue runs are simply skipped.
+ */
+#define DONGLE_WIDGET_LISTENER(listener, state_type, cb, state_func)                               \
+    static STATE_MAILBOX(state_type) listener##_state;                                             \
+    static void listener##_refresh_state(const zmk_event_t *eh) {                                  \
+        state_type state = state_func(eh);                                                         \
+        STATE_MAILBOX_PUT(&listener##_state, state);                                               \
+    };                                                                                             \
+    static bool listener##_apply(void) {                                                           \
+        state_type state;                                                                          \
+        if (!STATE_MAILBOX_GET(&listener##_state, state)) {                                        \
+            return false;                                                                          \
+        }                                                                                          \
+        cb(state);                                                                                 \
+        return true;                                                                               \
+    }                                                                                              \
+    static struct dongle_widget_mailbox listener##_mailbox = {.apply = listener##_apply};          \
+    static void listener##_init() {                                                                \
+        listener##_refresh_state(NULL);                                                            \
+        dongle_display_render_register(&listener##_mailbox);                                       \
+        listener##_apply();                                                                        \
+    }                                                                                              \
+    static int listener##_cb(const zmk_event_t *eh) {                                              \
+        timing_t profile_start = listener_profiler_start();                                        \
+        listener##_refresh_state(eh);                                                              \
+        dongle_display_render_request(&listener##_mailbox);                                        \
+        listener_profiler_stop(#listener, eh, profile_start);                                      \
+        return ZMK_EV_EVENT_BUBBLE;                                                                \
+    }                                                                                              \
+    ZMK_LISTENER(listener, listener##_cb);
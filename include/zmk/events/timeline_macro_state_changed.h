@@ -0,0 +1,14 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+struct zmk_timeline_macro_state_changed {
+    uint8_t index;
+    uint16_t step;
+    uint16_t steps;
+    bool active;
+    bool cancelled;
+};
+
+ZMK_EVENT_DECLARE(zmk_timeline_macro_state_changed);
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_behavior_display_page
+
+#include <zephyr/device.h>
+#include <zephyr/toolchain.h>
+#include <drivers/behavior.h>
+#include <zephyr/logging/log.h>
+#include <zmk/behavior.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
+
+/*
+ * The keymap is shared with builds that have no dongle display. Those still get the behavior,
+ * the dongle display status screen overrides this with the real page switch.
+ */
+__weak void zmk_display_status_screen_next_page(void) {}
+
+static int on_display_page_binding_pressed(struct zmk_behavior_binding *binding,
+                                           struct zmk_behavior_binding_event event) {
+    zmk_display_status_screen_next_page();
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static int on_display_page_binding_released(struct zmk_behavior_binding *binding,
+                                            struct zmk_behavior_binding_event event) {
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static const struct behavior_driver_api behavior_display_page_driver_api = {
+    .binding_pressed = on_display_page_binding_pressed,
+    .binding_released = on_display_page_binding_released,
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+    .get_parameter_metadata = zmk_behavior_get_empty_param_metadata,
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+};
+
+#define DPG_INST(n)                                                                                \
+    BEHAVIOR_DT_INST_DEFINE(n, NULL, NULL, NULL, NULL, POST_KERNEL,                                \
+                            CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,                                   \
+                            &behavior_display_page_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(DPG_INST)
+
+#endif
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_behavior_timeline_macro
+
+#include <string.h>
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <drivers/behavior.h>
+#include <zephyr/logging/log.h>
+#include <zmk/behavior.h>
+#include <zmk/behavior_queue.h>
+#include <zmk/keymap.h>
+#include <zmk/events/timeline_macro_state_changed.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
+
+#define IS_WAIT_TIME(dev)                                                                          \
+    (strcmp(dev, DEVICE_DT_NAME(DT_INST(0, zmk_macro_control_wait_time))) == 0)
+#define IS_TAP_TIME(dev) (strcmp(dev, DEVICE_DT_NAME(DT_INST(0, zmk_macro_control_tap_time))) == 0)
+
+/* controls that need the press/release state machine of zmk,behavior-macro */
+#define IS_COMPAT_DEV(dev, compat)                                                                 \
+    COND_CODE_1(DT_HAS_COMPAT_STATUS_OKAY(compat),                                                 \
+                (strcmp(dev, DEVICE_DT_NAME(DT_INST(0, compat))) == 0), (false))
+#define IS_UNSUPPORTED_CONTROL(dev)                                                                \
+    (IS_COMPAT_DEV(dev, zmk_macro_control_mode_tap) ||                                             \
+     IS_COMPAT_DEV(dev, zmk_macro_control_mode_press) ||                                           \
+     IS_COMPAT_DEV(dev, zmk_macro_control_mode_release) ||                                         \
+     IS_COMPAT_DEV(dev, zmk_macro_pause_for_release) ||                                            \
+     IS_COMPAT_DEV(dev, zmk_macro_param_1to1) || IS_COMPAT_DEV(dev, zmk_macro_param_1to2) ||       \
+     IS_COMPAT_DEV(dev, zmk_macro_param_2to1) || IS_COMPAT_DEV(dev, zmk_macro_param_2to2))
+
+/* One press or release, `offset_ms` after the macro was triggered */
+struct timeline_entry {
+    uint32_t offset_ms;
+    uint8_t binding;
+    bool press;
+};
+
+struct behavior_timeline_macro_config {
+    uint8_t index;
+    uint32_t default_wait_ms;
+    uint32_t default_tap_ms;
+    uint8_t count;
+    struct zmk_behavior_binding bindings[];
+};
+
+struct behavior_timeline_macro_data {
+    const struct device *dev;
+    struct k_work_delayable timer;
+    struct zmk_behavior_binding_event event;
+    struct timeline_entry *timeline;
+    uint16_t steps;
+    uint16_t next;
+    int64_t start;
+    bool active;
+};
+
+static void raise_progress(const struct device *dev, bool cancelled) {
+    const struct behavior_timeline_macro_config *cfg = dev->config;
+    struct behavior_timeline_macro_data *data = dev->data;
+
+    raise_zmk_timeline_macro_state_changed((struct zmk_timeline_macro_state_changed){
+        .index = cfg->index,
+        .step = data->next,
+        .steps = data->steps,
+        .active = data->active,
+        .cancelled = cancelled,
+    });
+}
+
+/*
+ * Flatten the bindings into absolute press/release offsets, using the same tap/wait semantics
+ * as zmk,behavior-macro: every binding is held for tap-ms and followed by wait-ms, and the
+ * controls change those values for all following bindings.
+ */
+static int compile_timeline(const struct behavior_timeline_macro_config *cfg,
+                            struct behavior_timeline_macro_data *data) {
+    uint32_t wait_ms = cfg->default_wait_ms;
+    uint32_t tap_ms = cfg->default_tap_ms;
+    uint32_t offset_ms = 0;
+
+    data->steps = 0;
+
+    for (int i = 0; i < cfg->count; i++) {
+        const struct zmk_behavior_binding *binding = &cfg->bindings[i];
+
+        if (IS_WAIT_TIME(binding->behavior_dev)) {
+            wait_ms = binding->param1;
+            continue;
+        }
+        if (IS_TAP_TIME(binding->behavior_dev)) {
+            tap_ms = binding->param1;
+            continue;
+        }
+        if (IS_UNSUPPORTED_CONTROL(binding->behavior_dev)) {
+            LOG_ERR("Timeline macro %d: %s is not supported", cfg->index, binding->behavior_dev);
+            return -ENOTSUP;
+        }
+
+        data->timeline[data->steps++] =
+            (struct timeline_entry){.offset_ms = offset_ms, .binding = i, .press = true};
+        offset_ms += tap_ms;
+        data->timeline[data->steps++] =
+            (struct timeline_entry){.offset_ms = offset_ms, .binding = i, .press = false};
+        offset_ms += wait_ms;
+    }
+
+    LOG_DBG("Timeline macro %d: %d steps over %d ms", cfg->index, data->steps, offset_ms);
+    return 0;
+}
+
+/*
+ * One timer per running macro on the system work queue, which emits every other behavior too,
+ * so `data` is only ever modified there and needs no locking.
+ */
+static void timeline_macro_timer_cb(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct behavior_timeline_macro_data *data =
+        CONTAINER_OF(dwork, struct behavior_timeline_macro_data, timer);
+    const struct behavior_timeline_macro_config *cfg = data->dev->config;
+
+    if (!data->active) {
+        return;
+    }
+
+    int64_t elapsed = k_uptime_get() - data->start;
+
+    while (data->next < data->steps && data->timeline[data->next].offset_ms <= elapsed) {
+        const struct timeline_entry *entry = &data->timeline[data->next++];
+        zmk_behavior_queue_add(&data->event, cfg->bindings[entry->binding], entry->press, 0);
+    }
+
+    if (data->next < data->steps) {
+        /* absolute deadline, so long timelines do not accumulate scheduling drift */
+        k_work_schedule(&data->timer,
+                        K_TIMEOUT_ABS_MS(data->start + data->timeline[data->next].offset_ms));
+    } else {
+        data->active = false;
+    }
+
+    raise_progress(data->dev, false);
+}
+
+static void cancel_timeline_macro(const struct device *dev) {
+    const struct behavior_timeline_macro_config *cfg = dev->config;
+    struct behavior_timeline_macro_data *data = dev->data;
+
+    k_work_cancel_delayable(&data->timer);
+
+    /* never leave a binding held down */
+    if (data->next < data->steps && !data->timeline[data->next].press) {
+        const struct timeline_entry *entry = &data->timeline[data->next];
+        zmk_behavior_queue_add(&data->event, cfg->bindings[entry->binding], false, 0);
+    }
+
+    data->active = false;
+
+    LOG_DBG("Timeline macro %d cancelled at step %d/%d", cfg->index, data->next, data->steps);
+    raise_progress(dev, true);
+}
+
+static int on_timeline_macro_binding_pressed(struct zmk_behavior_binding *binding,
+                                             struct zmk_behavior_binding_event event) {
+    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    struct behavior_timeline_macro_data *data = dev->data;
+
+    if (data->active) {
+        cancel_timeline_macro(dev);
+        return ZMK_BEHAVIOR_OPAQUE;
+    }
+
+    data->event = event;
+    data->start = k_uptime_get();
+    data->next = 0;
+    data->active = true;
+    k_work_schedule(&data->timer, K_NO_WAIT);
+
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static int on_timeline_macro_binding_released(struct zmk_behavior_binding *binding,
+                                              struct zmk_behavior_binding_event event) {
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static const struct behavior_driver_api behavior_timeline_macro_driver_api = {
+    .binding_pressed = on_timeline_macro_binding_pressed,
+    .binding_released = on_timeline_macro_binding_released,
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+    .get_parameter_metadata = zmk_behavior_get_empty_param_metadata,
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+};
+
+static int behavior_timeline_macro_init(const struct device *dev) {
+    const struct behavior_timeline_macro_config *cfg = dev->config;
+    struct behavior_timeline_macro_data *data = dev->data;
+
+    data->dev = dev;
+    k_work_init_delayable(&data->timer, timeline_macro_timer_cb);
+
+    return compile_timeline(cfg, data);
+}
+
+#define TRANSFORMED_BINDINGS(n)                                                                    \
+    {LISTIFY(DT_PROP_LEN(DT_DRV_INST(n), bindings), ZMK_KEYMAP_EXTRACT_BINDING, (, ),             \
+             DT_DRV_INST(n))}
+
+#define TML_INST(n)                                                                                \
+    static struct timeline_entry                                                                   \
+        behavior_timeline_macro_entries_##n[DT_INST_PROP_LEN(n, bindings) * 2];                   \
+    static struct behavior_timeline_macro_data behavior_timeline_macro_data_##n = {                \
+        .timeline = behavior_timeline_macro_entries_##n,                                           \
+    };                                                                                             \
+    static const struct behavior_timeline_macro_config behavior_timeline_macro_config_##n = {     \
+        .index = n,                                                                                \
+        .default_wait_ms = DT_INST_PROP_OR(n, wait_ms, CONFIG_ZMK_MACRO_DEFAULT_WAIT_MS),          \
+        .default_tap_ms = DT_INST_PROP_OR(n, tap_ms, CONFIG_ZMK_MACRO_DEFAULT_TAP_MS),             \
+        .count = DT_INST_PROP_LEN(n, bindings),                                                    \
+        .bindings = TRANSFORMED_BINDINGS(n),                                                       \
+    };                                                                                             \
+    BEHAVIOR_DT_INST_DEFINE(n, behavior_timeline_macro_init, NULL,                                 \
+                            &behavior_timeline_macro_data_##n,                                     \
+                            &behavior_timeline_macro_config_##n, POST_KERNEL,                      \
+                            CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,                                   \
+                            &behavior_timeline_macro_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(TML_INST)
+
+#endif
@@ -0,0 +1,4 @@
+#include <zephyr/kernel.h>
+#include <zmk/events/timeline_macro_state_changed.h>
+
+ZMK_EVENT_IMPL(zmk_timeline_macro_state_changed);